@@ -28,6 +28,7 @@ typedef enum {
     NTACT_TANH,      ///< Hyperbolic tangent activation function
     NTACT_RELU,      ///< Rectified Linear Unit activation function
     NTACT_LRELU,     ///< Leaky Rectified Linear Unit activation function
+    NTACT_SOFTMAX,   ///< Softmax activation function, normalized layer-wide
 
     NTACT_TOTAL_FUNCTIONS ///< Total number of activation functions
 } ntact_function_id_t;
@@ -11,6 +11,7 @@
 #define NTBUILDER_H
 
 #include "ntcore.h"
+#include "ntmemory.h"
 #include <stddef.h>
 
 /**
@@ -65,4 +66,58 @@ struct net_s *newnet (net_s *net , uint16_t *neurons_per_layer , layer_t layers_
  */
 struct net_s *buildnet( net_s *net );
 
+/**
+ * @brief Resolves wiring descriptors like buildnet(), over an existing
+ *        block of weights.
+ *
+ * @param net Network with wiring descriptors already defined.
+ * @param weights Shared block of `net` holding its padded weight rows.
+ * @param size Size of the block, in bytes.
+ * @return The same `net` pointer, or NULL if the rows do not fit.
+ */
+struct net_s *buildshared( net_s *net , weight_t *weights , size_t size );
+
+/**
+ * @brief Builds a copy of a network that shares its weights until either
+ *        one is modified.
+ *
+ * @param clone Network to build; its previous contents are ignored.
+ * @param net Built network to copy; must outlive the clone.
+ * @return `clone`, or NULL on failure.
+ */
+struct net_s *clonenet( net_s *clone , net_s *net );
+
+/**
+ * @brief Gives a network a private copy of its weights if they are
+ *        shared with a clone.
+ *
+ * @param net Built network about to modify its weights.
+ * @return `net`, or NULL on failure.
+ */
+struct net_s *ownweights( net_s *net );
+
+/**
+ * @brief Builds a copy of a network with its memory placed as requested.
+ *
+ * @param replica Network to build; its previous contents are ignored.
+ * @param net Built network to copy; must outlive the replica.
+ * @param placement Page size and NUMA node of the replica's memory, or
+ *                  NULL for plain heap memory.
+ * @return `replica`, or NULL on failure.
+ */
+struct net_s *replicanet( net_s *replica , net_s *net , const placement_s *placement );
+
+/**
+ * @brief Finds the neuron whose output a buffer element reads.
+ *
+ * @param net Network whose wiring descriptors are defined.
+ * @param i Wiring layer of the buffer.
+ * @param j Buffer index within that layer.
+ * @param k Element of the buffer.
+ * @param layer Receives the source neuron's layer.
+ * @param index Receives the source neuron's index within its layer.
+ * @return 1 if the element is a neuron output, 0 otherwise.
+ */
+int resolvesource( const net_s *net , layer_t i , index_t j , input_t k , layer_t *layer , uint16_t *index );
+
 #endif // NTBUILDER_H
\ No newline at end of file
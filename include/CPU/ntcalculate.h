@@ -28,6 +28,27 @@ data_t weighing( neuron_s *neuron );
  */
 data_t activate( neuron_s *neuron );
 
+/**
+ * @brief Returns the input values a packed layer gathered in the last
+ *        forward pass.
+ *
+ * @param net Pointer to a built net_s instance.
+ * @param layer Layer to query.
+ * @return layer_s::x, or NULL if the layer is not packed.
+ */
+const data_t *layerinputs( const net_s *net , layer_t layer );
+
+/**
+ * @brief Computes the weighted sum of one neuron, through its layer's
+ *        packed view when it has one.
+ *
+ * @param net Pointer to a built net_s instance, after a forward pass.
+ * @param layer Layer of the neuron.
+ * @param neuron Index of the neuron within its layer.
+ * @return Weighted sum including bias.
+ */
+data_t layerweighing( net_s *net , layer_t layer , uint16_t neuron );
+
 /**
  * @brief Executes full feedforward propagation.
  *
@@ -44,4 +65,28 @@ data_t activate( neuron_s *neuron );
  */
 data_t **feedforward( net_s *net );
 
+/**
+ * @brief Executes feedforward propagation from a given layer onward,
+ *        keeping the current outputs of every earlier layer.
+ *
+ * @param net Pointer to a net_s instance whose base structure has already
+ *            been built.
+ * @param layer First layer to compute.
+ * @return The network's own output array (net_s::out).
+ */
+data_t **forwardfrom( net_s *net , layer_t layer );
+
+/**
+ * @brief Executes full feedforward propagation and ranks the network's
+ *        outputs in the same pass.
+ *
+ * @param net Pointer to a net_s instance whose base structure has already
+ *            been built.
+ * @param k Number of highest outputs to report through `index`.
+ * @param index Array of at least `k` elements, filled with the indices of
+ *              the `k` highest outputs, highest first. May be NULL.
+ * @return Index of the highest output (argmax).
+ */
+uint16_t classify( net_s *net , uint16_t k , uint16_t *index );
+
 #endif // NTCALCULATE_H
\ No newline at end of file
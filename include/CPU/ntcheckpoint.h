@@ -0,0 +1,61 @@
+/**
+ * @file ntcheckpoint.h
+ * @copybrief ntcheckpoint.c
+ * 
+ * @ref http://tituxdev.github.io/NeuroTIC/src/CPU/ntcheckpoint.c
+ *
+ * @copydetails ntcheckpoint.c
+ */
+
+#ifndef NTCHECKPOINT_H
+#define NTCHECKPOINT_H
+
+#include "nttrain.h"
+
+/**
+ * @brief When and where a training run is checkpointed.
+ */
+typedef struct checkpointconfig_s {
+    const char  *name;          /**< Base filename (without extension) of the checkpoint. */
+    attempts_t  epochs;         /**< Checkpoint every this many epochs; 0 disables. */
+    double      seconds;        /**< Checkpoint once this many seconds have passed since the last one; 0 disables. */
+} checkpointconfig_s;
+
+/**
+ * @brief Opaque state of an installed checkpointer.
+ */
+typedef struct checkpoint_s checkpoint_s;
+
+/**
+ * @brief Installs periodic, asynchronous checkpointing of a network on a
+ *        training dataset's hook chain.
+ *
+ * @param net Network to checkpoint; its structure must not change while
+ *            the checkpointer is installed.
+ * @param train_data Dataset the network is trained with.
+ * @param config Checkpoint settings.
+ * @return The installed checkpointer, or NULL if it could not be created.
+ */
+checkpoint_s *newcheckpoint( net_s *net , traindata_t *train_data , const checkpointconfig_s *config );
+
+/**
+ * @brief Snapshots the network now and writes it in the background,
+ *        regardless of the configured period.
+ *
+ * @param checkpoint Installed checkpointer.
+ * @return 1 if a snapshot was taken, 0 if the previous one is still
+ *         being written.
+ */
+int checkpointnow( checkpoint_s *checkpoint );
+
+/**
+ * @brief Waits for any pending write, removes the checkpointer from its
+ *        dataset's hook chain and releases it.
+ *
+ * @param checkpoint Checkpointer returned by newcheckpoint(); NULL is
+ *                   ignored.
+ * @return Number of checkpoints written successfully.
+ */
+size_t freecheckpoint( checkpoint_s *checkpoint );
+
+#endif // NTCHECKPOINT_H
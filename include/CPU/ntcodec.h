@@ -0,0 +1,54 @@
+/**
+ * @file ntcodec.h
+ * @copybrief ntcodec.c
+ * 
+ * @ref http://tituxdev.github.io/NeuroTIC/src/CPU/ntcodec.c
+ *
+ * @copydetails ntcodec.c
+ */
+
+#ifndef NTCODEC_H
+#define NTCODEC_H
+
+#include <stddef.h>
+
+/**
+ * @brief Largest output ntpack() can produce for an input of `size` bytes.
+ *
+ * @param size Input size, in bytes.
+ * @return Capacity that always suffices for ntpack()'s output.
+ */
+size_t ntpackbound( size_t size );
+
+/**
+ * @brief Largest output ntunpack() can produce from `size` compressed bytes.
+ *
+ * @param size Compressed size, in bytes.
+ * @return Size no valid block of `size` bytes decompresses beyond.
+ */
+size_t ntunpackbound( size_t size );
+
+/**
+ * @brief Compresses a block of bytes.
+ *
+ * @param src Bytes to compress.
+ * @param size Number of bytes at `src`.
+ * @param dst Destination of the compressed block.
+ * @param capacity Size of `dst`, in bytes; ntpackbound( size ) always suffices.
+ * @return Size of the compressed block, or 0 if it did not fit.
+ */
+size_t ntpack( const void *src , size_t size , void *dst , size_t capacity );
+
+/**
+ * @brief Decompresses a block written by ntpack().
+ *
+ * @param src Compressed block.
+ * @param size Size of the compressed block, in bytes.
+ * @param dst Destination of the decompressed bytes.
+ * @param capacity Size of `dst`, in bytes.
+ * @return Number of bytes decompressed, or 0 if the block is malformed or
+ *         does not fit.
+ */
+size_t ntunpack( const void *src , size_t size , void *dst , size_t capacity );
+
+#endif // NTCODEC_H
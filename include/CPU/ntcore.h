@@ -4,7 +4,8 @@
  * @author Oscar Sotomayor (Titux)
  *
  * Declares the minimal structural components required to represent a
- * network: neurons, wiring descriptors, and the root network container.
+ * network: neurons, wiring descriptors, packed layer views, and the root
+ * network container.
  *
  * These types define structure only -- no construction or execution
  * semantics are provided.
@@ -83,6 +84,29 @@ typedef struct wiring_s {
 } wiring_s;
 
 
+/* ------------------------------------------------------------------------- */
+/* Layer                                                                     */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Packed structure-of-arrays view of a layer's hot data.
+ *
+ * When every neuron of a layer reads the same input set, drawn from the
+ * network inputs or earlier layers only, and their weight arrays are
+ * laid out back to back, the weights form one row-major
+ * matrix whose rows are the neurons' own neuron_s::w, and the shared
+ * inputs can be gathered once into a contiguous vector. Neurons stay the
+ * authoritative records; the view only aliases their storage.
+ */
+typedef struct layer_s {
+    data_t      **in;       /**< Input references shared by every neuron. */
+    input_t     inputs;     /**< Logical number of inputs per neuron. */
+    input_t     stride;     /**< Distance between consecutive rows of `w`, in weights. */
+    weight_t    *w;         /**< Weight matrix, one row per neuron; NULL if the layer is not packed. */
+    data_t      *x;         /**< Input values gathered by the last forward pass. */
+} layer_s;
+
+
 /* ------------------------------------------------------------------------- */
 /* Network                                                                   */
 /* ------------------------------------------------------------------------- */
@@ -105,6 +129,7 @@ typedef struct net_s {
     wiring_s    *wiring;    /**< Wiring descriptors per layer. */
     data_t      ****bff;    /**< Buffer reference sets. */
     data_t      **out;      /**< Output references. */
+    layer_s     *layer;     /**< Packed per-layer views. */
 } net_s;
 
 #endif // NTCORE_H
@@ -0,0 +1,72 @@
+/**
+ * @file ntdataset.h
+ * @copybrief ntdataset.c
+ * 
+ * @ref http://tituxdev.github.io/NeuroTIC/src/CPU/ntdataset.c
+ *
+ * @copydetails ntdataset.c
+ */
+
+#ifndef NTDATASET_H
+#define NTDATASET_H
+
+#include <stddef.h>
+#include "nttrain.h"
+
+/**
+ * @brief Layout of a delimited text file read by importcsv().
+ */
+typedef struct csvformat_s {
+    char        delimiter;          /**< Field separator; 0 detects tab, semicolon or comma from the first line read. */
+    uint32_t    skip;               /**< Leading lines to ignore, e.g. 1 for a header row. */
+    uint32_t    *in_columns;        /**< Column of each input value, size net_s::inputs; NULL reads columns 0 onward. */
+    uint32_t    *result_columns;    /**< Column of each expected output value; NULL reads the columns right after the inputs'. */
+    uint8_t     labeled;            /**< Nonzero reads `label_column` instead of `result_columns`; 0 reads expected outputs as values. */
+    uint32_t    label_column;       /**< Column holding a class index expanded to a one-hot output row, when `labeled` is set. */
+    unsigned    threads;            /**< Maximum parser threads; 0 uses every hardware thread. */
+} csvformat_s;
+
+/**
+ * @brief Saves a training dataset to a binary file with extension .ntds
+ *
+ * @param train_data Pointer to the dataset to save, with
+ *                   traindata_t::inputs and traindata_t::outputs set.
+ * @param name Base filename (without extension) to save the dataset as.
+ * @return The size, in bytes, of the file written.
+ */
+size_t savetraindata( traindata_t *train_data , const char *name );
+
+/**
+ * @brief Maps a binary .ntds file read-only into a training dataset,
+ *        without copying its matrices.
+ *
+ * @param train_data Pointer to a traindata_t instance to populate. Its
+ *                   training parameters are left untouched.
+ * @param name Base filename (without extension) to map the dataset from.
+ * @return 0 on success.
+ */
+size_t maptraindata( traindata_t *train_data , const char *name );
+
+/**
+ * @brief Imports a CSV/TSV file into a training dataset, parsing it on
+ *        several threads.
+ *
+ * @param train_data Pointer to a traindata_t instance to populate. Its
+ *                   training parameters are left untouched.
+ * @param net Pointer to the network being trained.
+ * @param path Full path of the file to import.
+ * @param format Layout of the file; NULL reads comma or tab separated
+ *               columns, inputs first, with no header row.
+ * @return 0 on success.
+ */
+size_t importcsv( traindata_t *train_data , net_s *net , const char *path , const csvformat_s *format );
+
+/**
+ * @brief Releases a dataset populated by maptraindata(), including its
+ *        file mapping.
+ *
+ * @param train_data Pointer to the dataset to release.
+ */
+void unmaptraindata( traindata_t *train_data );
+
+#endif // NTDATASET_H
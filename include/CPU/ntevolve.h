@@ -0,0 +1,39 @@
+/**
+ * @file ntevolve.h
+ * @copybrief ntevolve.c
+ * 
+ * @ref http://tituxdev.github.io/NeuroTIC/src/CPU/ntevolve.c
+ *
+ * @copydetails ntevolve.c
+ */
+
+#ifndef NTEVOLVE_H
+#define NTEVOLVE_H
+
+#include "nttrain.h"
+
+/**
+ * @brief Settings of an evolution strategy run.
+ */
+typedef struct evolveconfig_s {
+    uint32_t    population; /**< Candidates evaluated per generation, rounded up to an even number; 0 uses 64. */
+    uint32_t    elite;      /**< Best parameter sets kept across generations, ranked with each generation's candidates as parents; 0 keeps 1. */
+    float       sigma;      /**< Standard deviation of each perturbation; 0 uses 0.1. */
+    uint64_t    seed;       /**< Seed of every perturbation. */
+    unsigned    threads;    /**< Maximum number of threads; 0 uses every hardware thread. */
+} evolveconfig_s;
+
+/**
+ * @brief Trains a network without gradients, by evolving its weights and
+ *        biases with a population of random perturbations.
+ *
+ * @param net Pointer to the network to train; any activation, including
+ *            non-differentiable ones, is supported.
+ * @param train_data Pointer to the training data; `learning_rate` is not
+ *                   used.
+ * @param config Evolution settings; NULL uses every default.
+ * @return Number of generations performed.
+ */
+attempts_t evolvenet( net_s *net , traindata_t *train_data , const evolveconfig_s *config );
+
+#endif // NTEVOLVE_H
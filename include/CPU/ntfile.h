@@ -12,8 +12,29 @@
 #define NTFILE_H
 
 #include <stddef.h>
+#include <stdio.h>
 #include "ntcore.h"
 
+/**
+ * @brief Sink for savenet_stream().
+ *
+ * @param ctx Caller context passed to savenet_stream() unchanged.
+ * @param data Bytes to write.
+ * @param size Number of bytes to write.
+ * @return Number of bytes written; fewer than `size` aborts the save.
+ */
+typedef size_t ( *ntwrite_f )( void *ctx , const void *data , size_t size );
+
+/**
+ * @brief Source for loadnet_stream().
+ *
+ * @param ctx Caller context passed to loadnet_stream() unchanged.
+ * @param data Where to store the bytes read.
+ * @param size Maximum number of bytes to read.
+ * @return Number of bytes read, at least 1; 0 at the end of the input.
+ */
+typedef size_t ( *ntread_f )( void *ctx , void *data , size_t size );
+
 /**
  * @brief Saves a network to a binary file with extension .ntic
  * 
@@ -23,6 +44,75 @@
  */
 size_t savenet( net_s * net , const char *name );
 
+/**
+ * @brief Saves a network to an open stream.
+ *
+ * @param net Pointer to the network to save.
+ * @param fp Stream to write to, from its current position.
+ * @return The number of bytes written, or 0 on failure.
+ */
+size_t savenet_file( net_s *net , FILE *fp );
+
+/**
+ * @brief Saves a network to a file descriptor.
+ *
+ * @param net Pointer to the network to save.
+ * @param fd Descriptor to write to, from its current position.
+ * @return The number of bytes written, or 0 on failure.
+ */
+size_t savenet_fd( net_s *net , int fd );
+
+/**
+ * @brief Saves a network into a caller-provided buffer.
+ *
+ * @param net Pointer to the network to save.
+ * @param buffer Destination, or NULL to only measure.
+ * @param capacity Size of `buffer`, in bytes.
+ * @return The serialized size; larger than `capacity` if `buffer` was
+ *         too small to hold it.
+ */
+size_t savenet_mem( net_s *net , void *buffer , size_t capacity );
+
+/**
+ * @brief Saves a network through a writer callback.
+ *
+ * @param net Pointer to the network to save.
+ * @param write Callback receiving the serialized bytes in order.
+ * @param ctx Context passed to every `write` call.
+ * @return The number of bytes written, or 0 on failure.
+ */
+size_t savenet_stream( net_s *net , ntwrite_f write , void *ctx );
+
+/**
+ * @brief Saves a network to a compressed binary file with extension .ntic
+ *
+ * @param net Pointer to the network to save.
+ * @param name Base filename (without extension) to save the network as.
+ * @return The size, in bytes, of the file written, or 0 on failure.
+ */
+size_t savenet_packed( net_s *net , const char *name );
+
+/**
+ * @brief Saves a compressed network into a caller-provided buffer.
+ *
+ * @param net Pointer to the network to save.
+ * @param buffer Destination, or NULL to only measure.
+ * @param capacity Size of `buffer`, in bytes.
+ * @return The compressed size; larger than `capacity`, and nothing
+ *         written, if `buffer` was too small to hold it.
+ */
+size_t savenet_packed_mem( net_s *net , void *buffer , size_t capacity );
+
+/**
+ * @brief Saves a compressed network through a writer callback.
+ *
+ * @param net Pointer to the network to save.
+ * @param write Callback receiving the compressed bytes.
+ * @param ctx Context passed to `write`.
+ * @return The number of bytes written, or 0 on failure.
+ */
+size_t savenet_packed_stream( net_s *net , ntwrite_f write , void *ctx );
+
 /**
  * @brief Loads a network from a binary file with extension .ntic
  * 
@@ -32,4 +122,58 @@ size_t savenet( net_s * net , const char *name );
  */
 size_t loadnet( net_s *net , const char *name );
 
+/**
+ * @brief Loads a network from an open stream.
+ *
+ * @param net Pointer to a net_s instance to populate with the loaded network.
+ * @param fp Stream to read from, from its current position.
+ * @return 0 on success.
+ */
+size_t loadnet_file( net_s *net , FILE *fp );
+
+/**
+ * @brief Loads a network from a file descriptor.
+ *
+ * @param net Pointer to a net_s instance to populate with the loaded network.
+ * @param fd Descriptor to read from, from its current position.
+ * @return 0 on success.
+ */
+size_t loadnet_fd( net_s *net , int fd );
+
+/**
+ * @brief Loads a network from a buffer in memory.
+ *
+ * @param net Pointer to a net_s instance to populate with the loaded network.
+ * @param buffer Serialized network, as written by any save function.
+ * @param size Size of `buffer`, in bytes.
+ * @return 0 on success.
+ */
+size_t loadnet_mem( net_s *net , const void *buffer , size_t size );
+
+/**
+ * @brief Loads a network through a reader callback.
+ *
+ * @param net Pointer to a net_s instance to populate with the loaded network.
+ * @param read Callback supplying the serialized bytes in order.
+ * @param ctx Context passed to every `read` call.
+ * @return 0 on success.
+ */
+size_t loadnet_stream( net_s *net , ntread_f read , void *ctx );
+
+/**
+ * @name Portable encoding helpers
+ *
+ * Endianness and floating-point conversions used by every module that
+ * writes or reads NeuroTIC's little-endian IEEE 754 binary formats.
+ */
+/** @{ */
+uint8_t checkendian( void );
+uint16_t bswap16( uint16_t x );
+uint32_t bswap32( uint32_t x );
+uint64_t bswap64( uint64_t x );
+uint8_t isieee754( void );
+uint32_t float32( float x , uint8_t ieee754 );
+float floatsys( int32_t x , uint8_t ieee754 );
+/** @} */
+
 #endif // NTFILE_H
\ No newline at end of file
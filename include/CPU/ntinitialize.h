@@ -12,6 +12,30 @@
 
 #include "ntcore.h"
 
+/**
+ * @brief Weight initialization schemes accepted by initnet().
+ */
+typedef enum {
+    NTINIT_AUTO,    ///< He for rectifier activations, Xavier for every other
+    NTINIT_RANGE,   ///< Uniform within the activation's `ntact_rand_range`
+    NTINIT_XAVIER,  ///< Uniform, scaled by fan-in and fan-out (Glorot)
+    NTINIT_HE,      ///< Normal, scaled by fan-in (He)
+
+    NTINIT_TOTAL_MODES ///< Total number of initialization modes
+} ntinit_mode_t;
+
+/**
+ * @brief Initializes network weights from an explicit seed and resets
+ *        biases to zero.
+ *
+ * @param net Pointer to a net_s instance whose base structure has already
+ *            been built.
+ * @param seed Seed; the same seed and network always give the same
+ *             weights.
+ * @param mode Initialization scheme, one of `ntinit_mode_t`.
+ */
+void initnet( net_s *net , uint64_t seed , ntinit_mode_t mode );
+
 /**
  * @brief Randomly initializes network weights and resets biases to zero.
  *
@@ -20,4 +44,4 @@
  */
 void randnet( net_s *net);
 
-#endif // NTINITIALIZE_H
\ No newline at end of file
+#endif // NTINITIALIZE_H
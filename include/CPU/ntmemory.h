@@ -10,6 +10,37 @@
 #ifndef NTMEMORY_H
 #define NTMEMORY_H
 
+#include <stddef.h>
+#include <stdio.h>
+
+/** Alignment of every block handed out by arenaalloc(). */
+#define ARENA_ALIGN 16
+
+/** Bytes reserved right before every shared block for its reference count; keeps a slab's cache-line alignment. */
+#define SHARED_HEADER 64
+
+/**
+ * @brief Page sizes a placed owner's arena slabs may use.
+ */
+typedef enum {
+    NTPAGE_DEFAULT,     ///< Regular pages
+    NTPAGE_TRANSPARENT, ///< Transparent huge pages, requested with madvise()
+    NTPAGE_EXPLICIT,    ///< Reserved huge pages, falling back to transparent ones
+
+    NTPAGE_TOTAL_MODES ///< Total number of page modes
+} ntpage_mode_t;
+
+/**
+ * @brief Where an owner's arena slabs are placed; see placeowner().
+ */
+typedef struct placement_s{
+    ntpage_mode_t   pages;  /**< Page size of the slabs. */
+    int             node;   /**< NUMA node to bind them to, or -1 to leave them to first touch. */
+} placement_s;
+
+/** Bytes an arena spends on a block of `size` bytes; planning passes add these up to size createarena(). */
+#define ARENA_SIZE( size ) ( ( (size_t)(size) + ARENA_ALIGN - 1 ) & ~(size_t)( ARENA_ALIGN - 1 ) )
+
 /**
  * @brief Frees every tracked memory block, for every owner, and empties
  *        the tracking registry.
@@ -42,4 +73,132 @@ void *createowner( void *owner );
  */
 void *createregister( void *owner , void *mem );
 
+/**
+ * @brief Registers a memory block of known size under a memory owner.
+ * @param owner Pointer to the memory owner under which the memory block is registered.
+ * @param mem Pointer to the memory block to register.
+ * @param size Size of the block in bytes, as allocated.
+ * @return Pointer to the now-registered memory block.
+ */
+void *createblock( void *owner , void *mem , size_t size );
+
+/**
+ * @brief Registers a block obtained with mmap() under a memory owner.
+ * @param owner Pointer to the memory owner under which the mapping is registered.
+ * @param mem Start of the mapping.
+ * @param size Length of the mapping in bytes.
+ * @return Pointer to the now-registered mapping.
+ */
+void *createmapped( void *owner , void *mem , size_t size );
+
+/**
+ * @brief Allocates a zero-filled, reference-counted block that several
+ *        owners can hold.
+ * @param owner Pointer to the block's first holder.
+ * @param size Number of bytes requested.
+ * @return Pointer to the block, or NULL on failure.
+ */
+void *createshared( void *owner , size_t size );
+
+/**
+ * @brief Adopts a block inside an existing mapping as a shared block.
+ * @param owner Pointer to the block's first holder.
+ * @param map Start of the mapping, released with `munmap()` by the last
+ *            holder.
+ * @param length Length of the mapping.
+ * @param offset Offset of the block in the mapping; the
+ *               @ref SHARED_HEADER bytes before it are overwritten.
+ * @return Pointer to the block, or NULL on failure.
+ */
+void *createsharedmap( void *owner , void *map , size_t length , size_t offset );
+
+/**
+ * @brief Adds an owner as a holder of a shared block.
+ * @param owner Pointer to the new holder.
+ * @param from Pointer to an owner currently holding the block.
+ * @param mem Shared block, as returned by createshared().
+ * @return `mem`, or NULL on failure.
+ */
+void *shareblock( void *owner , void *from , void *mem );
+
+/**
+ * @brief Reports how many owners hold a shared block.
+ * @param owner Pointer to an owner holding the block.
+ * @param mem Shared block.
+ * @return Number of holders, or 0 if `owner` does not hold `mem` as a
+ *         shared block.
+ */
+size_t sharecount( void *owner , void *mem );
+
+/**
+ * @brief Unregisters and releases a single block of a memory owner.
+ * @param owner Pointer to the memory owner holding the block.
+ * @param mem Block to release.
+ * @return 0 on success.
+ */
+unsigned char deleteblock( void *owner , void *mem );
+
+/**
+ * @brief Sets the page size and NUMA node of an owner's future arena slabs.
+ * @param owner Pointer to the memory owner to place.
+ * @param placement Placement to apply, or NULL for plain heap slabs.
+ * @return 0 on success.
+ */
+unsigned char placeowner( void *owner , const placement_s *placement );
+
+/**
+ * @brief Returns the NUMA node the calling thread is running on.
+ * @return Node number, or -1 if unknown.
+ */
+int currentnode( void );
+
+/**
+ * @brief Allocates a zero-filled slab owned by `owner` and makes it the
+ *        owner's current arena.
+ * @param owner Pointer to the memory owner the slab is registered under.
+ * @param size Number of bytes to reserve, usually a sum of ARENA_SIZE().
+ * @return Pointer to the slab, or NULL on failure.
+ */
+void *createarena( void *owner , size_t size );
+
+/**
+ * @brief Allocates a zero-filled block owned by `owner` from its current
+ *        arena, chaining in a new slab when the arena is full.
+ * @param owner Pointer to the memory owner the block belongs to.
+ * @param size Number of bytes requested.
+ * @return Pointer to the block, or NULL on failure.
+ */
+void *arenaalloc( void *owner , size_t size );
+
+/**
+ * @brief Memory accounted to one owner, or to the whole registry.
+ */
+typedef struct memusage_s{
+    size_t  owners;     /**< Owners counted. */
+    size_t  blocks;     /**< Registered blocks. */
+    size_t  bytes;      /**< Bytes in those blocks, as declared when they were registered; a shared block counts toward each owner holding it, but once in the registry's total. */
+    size_t  peak;       /**< Highest `bytes` ever reached. */
+    size_t  slack;      /**< Of `bytes`, arena space not handed out yet. */
+    size_t  overhead;   /**< Bytes the registry itself spends tracking them. */
+} memusage_s;
+
+/**
+ * @brief Reports the memory registered under one owner.
+ * @param owner Pointer to the memory owner to query.
+ * @return Its usage; all zeros if `owner` is not tracked.
+ */
+memusage_s ownerusage( const void *owner );
+
+/**
+ * @brief Reports the memory registered under every owner.
+ * @return Usage summed over the whole registry.
+ */
+memusage_s memoryusage( void );
+
+/**
+ * @brief Prints the usage of every owner, then the totals.
+ * @param stream Stream to write to.
+ */
+void dumpmemory( FILE *stream );
+
 #endif // NTMEMORY_H
\ No newline at end of file
@@ -0,0 +1,47 @@
+/**
+ * @file ntoptimize.h
+ * @copybrief ntoptimize.c
+ * 
+ * @ref http://tituxdev.github.io/NeuroTIC/src/CPU/ntoptimize.c
+ *
+ * @copydetails ntoptimize.c
+ */
+
+#ifndef NTOPTIMIZE_H
+#define NTOPTIMIZE_H
+
+#include "nttrain.h"
+
+/**
+ * @brief Trains a network with the Levenberg-Marquardt method over the
+ *        whole training set.
+ *
+ * @param net Pointer to the network to train.
+ * @param train_data Pointer to the training data; `learning_rate` is not
+ *                   used.
+ * @return Number of iterations performed.
+ */
+attempts_t levenbergmarquardt( net_s *net , traindata_t *train_data );
+
+/**
+ * @brief Trains a network with the L-BFGS method over the whole training
+ *        set.
+ *
+ * @param net Pointer to the network to train.
+ * @param train_data Pointer to the training data; `learning_rate` is not
+ *                   used.
+ * @return Number of iterations performed.
+ */
+attempts_t lbfgs( net_s *net , traindata_t *train_data );
+
+/**
+ * @brief Trains a network with the method best suited to its size:
+ *        Levenberg-Marquardt, L-BFGS or backpropagation.
+ *
+ * @param net Pointer to the network to train.
+ * @param train_data Pointer to the training data.
+ * @return Number of iterations or epochs performed.
+ */
+attempts_t trainnet( net_s *net , traindata_t *train_data );
+
+#endif // NTOPTIMIZE_H
@@ -0,0 +1,47 @@
+/**
+ * @file ntpipeline.h
+ * @copybrief ntpipeline.c
+ * 
+ * @ref http://tituxdev.github.io/NeuroTIC/src/CPU/ntpipeline.c
+ *
+ * @copydetails ntpipeline.c
+ */
+
+#ifndef NTPIPELINE_H
+#define NTPIPELINE_H
+
+#include "nttrain.h"
+
+/**
+ * @brief Settings of a training input pipeline.
+ */
+typedef struct pipelineconfig_s {
+    sample_t    batch;      /**< Samples gathered per batch; 0 uses 64. */
+    uint32_t    depth;      /**< Batches buffered ahead of training; below 2 uses 2. */
+    uint64_t    seed;       /**< Seed of the shuffling order. */
+    uint8_t     shuffle;    /**< Nonzero visits samples in a new order every epoch. */
+} pipelineconfig_s;
+
+/**
+ * @brief Opaque state of a running pipeline.
+ */
+typedef struct pipeline_s pipeline_s;
+
+/**
+ * @brief Starts a background loader feeding a dataset to training.
+ *
+ * @param train_data Dataset to read from -- allocated, imported or mapped.
+ *                   Its traindata_t::sampler is pointed at the pipeline.
+ * @param config Pipeline settings; NULL uses the defaults, in order.
+ * @return The running pipeline, or NULL if it could not be started.
+ */
+pipeline_s *newpipeline( traindata_t *train_data , const pipelineconfig_s *config );
+
+/**
+ * @brief Stops a pipeline's loader and releases it.
+ *
+ * @param pipeline Pipeline returned by newpipeline(); NULL is ignored.
+ */
+void freepipeline( pipeline_s *pipeline );
+
+#endif // NTPIPELINE_H
@@ -0,0 +1,73 @@
+/**
+ * @file ntrandom.h
+ * @copybrief ntrandom.c
+ * 
+ * @ref http://tituxdev.github.io/NeuroTIC/src/CPU/ntrandom.c
+ *
+ * @copydetails ntrandom.c
+ */
+
+#ifndef NTRANDOM_H
+#define NTRANDOM_H
+
+#include <stdint.h>
+
+/**
+ * @brief State of one pseudo-random number stream.
+ */
+typedef struct ntrand_s {
+    uint64_t    s[4];   /**< xoshiro256** state; never all zero. */
+} ntrand_s;
+
+/**
+ * @brief Seeds a stream. The same seed always yields the same sequence.
+ *
+ * @param rng Stream to seed.
+ * @param seed Any value, including 0.
+ */
+void ntseed( ntrand_s *rng , uint64_t seed );
+
+/**
+ * @brief Draws the next 64 random bits of a stream.
+ *
+ * @param rng Seeded stream.
+ * @return Uniformly distributed 64-bit value.
+ */
+uint64_t ntrand( ntrand_s *rng );
+
+/**
+ * @brief Draws a uniformly distributed integer below `bound`.
+ *
+ * @param rng Seeded stream.
+ * @param bound Exclusive upper limit; 0 always yields 0.
+ * @return Value in `[0, bound)`.
+ */
+uint64_t ntrandbelow( ntrand_s *rng , uint64_t bound );
+
+/**
+ * @brief Draws a uniformly distributed float in `[0, 1)`.
+ *
+ * @param rng Seeded stream.
+ * @return Value in `[0, 1)`.
+ */
+float ntrandfloat( ntrand_s *rng );
+
+/**
+ * @brief Draws a normally distributed float with mean 0 and standard
+ *        deviation 1.
+ *
+ * @param rng Seeded stream.
+ * @return Standard normal value.
+ */
+float ntrandnormal( ntrand_s *rng );
+
+/**
+ * @brief Scrambles a 64-bit value into a well-mixed one (SplitMix64
+ *        finalizer). Distinct inputs always give distinct outputs.
+ *
+ * @param x Value to scramble.
+ * @return Scrambled value.
+ */
+uint64_t ntmix( uint64_t x );
+
+#endif // NTRANDOM_H
@@ -0,0 +1,73 @@
+/**
+ * @file ntsweep.h
+ * @copybrief ntsweep.c
+ * 
+ * @ref http://tituxdev.github.io/NeuroTIC/src/CPU/ntsweep.c
+ *
+ * @copydetails ntsweep.c
+ */
+
+#ifndef NTSWEEP_H
+#define NTSWEEP_H
+
+#include "nttrain.h"
+#include "ntinitialize.h"
+
+/**
+ * @brief One network configuration to train in a sweep.
+ */
+typedef struct sweepvariant_s {
+    layer_t         layers;         /**< Number of layers. */
+    uint16_t        *neurons;       /**< Neuron count per layer, size `layers`; the last must match the dataset's outputs. */
+    index_t         *fn;            /**< Activation of each layer, size `layers`; NULL keeps the default. */
+    net_s           *( *wire )( net_s *net );   /**< Wiring to apply, e.g. newdense(); NULL uses newfeedforward(). */
+    precision_t     learning_rate;  /**< Learning rate; 0 uses the dataset's. */
+    attempts_t      max_attempts;   /**< Epoch limit; 0 uses the dataset's. */
+    uint64_t        seed;           /**< Seed passed to initnet(). */
+    ntinit_mode_t   init;           /**< Initialization mode passed to initnet(). */
+} sweepvariant_s;
+
+/**
+ * @brief Outcome of one variant of a sweep.
+ */
+typedef struct sweepresult_s {
+    net_s       net;        /**< Trained network, kept only when requested; owns its memory. */
+    precision_t loss;       /**< Mean absolute error per output value on the validation set; infinite if the variant failed. */
+    attempts_t  epochs;     /**< Epochs the variant trained for. */
+    size_t      rank;       /**< Position of the variant once sorted by `loss`, from 0. */
+} sweepresult_s;
+
+/**
+ * @brief Trains many network variants concurrently on one shared dataset
+ *        and ranks them by validation loss.
+ *
+ * @param variants Configurations to train.
+ * @param count Number of variants.
+ * @param train_data Dataset every variant trains on; only read.
+ * @param validation Dataset every variant is scored on; NULL scores on
+ *                   `train_data`.
+ * @param threads Maximum number of variants trained at once; 0 uses every
+ *                hardware thread.
+ * @param results Outcome of each variant, in `variants` order, size `count`.
+ * @param keep Nonzero keeps every trained network in `results`; otherwise
+ *             each is freed once scored.
+ * @param name If non-NULL, the best network is saved with savenet() under
+ *             this name.
+ * @return Index of the best variant, or `count` if none could be trained
+ *         (or saving failed).
+ */
+size_t sweepnets( const sweepvariant_s *variants , size_t count , const traindata_t *train_data , const traindata_t *validation , unsigned threads , sweepresult_s *results , uint8_t keep , const char *name );
+
+/**
+ * @brief Averages the outputs of the best networks kept by sweepnets().
+ *
+ * @param results Results of a sweep run with `keep` set.
+ * @param count Number of results.
+ * @param members Number of best-ranked networks to average.
+ * @param x Input row.
+ * @param out Averaged output row.
+ * @return Number of networks averaged.
+ */
+size_t ensembleoutput( sweepresult_s *results , size_t count , size_t members , data_t *x , data_t *out );
+
+#endif // NTSWEEP_H
@@ -0,0 +1,44 @@
+/**
+ * @file ntthread.h
+ * @copybrief ntthread.c
+ * 
+ * @ref http://tituxdev.github.io/NeuroTIC/src/CPU/ntthread.c
+ *
+ * @copydetails ntthread.c
+ */
+
+#ifndef NTTHREAD_H
+#define NTTHREAD_H
+
+#include <stddef.h>
+
+/**
+ * @brief Work callback run by ntparallel() over one contiguous range.
+ *
+ * @param ctx Caller context passed to ntparallel() unchanged.
+ * @param begin First work item of the range.
+ * @param end One past the last work item of the range.
+ * @param worker Index of the worker running the range, from 0.
+ */
+typedef void ( *ntrange_f )( void *ctx , size_t begin , size_t end , unsigned worker );
+
+/**
+ * @brief Number of hardware threads available to the process.
+ *
+ * @return At least 1.
+ */
+unsigned ntthreads( void );
+
+/**
+ * @brief Splits `count` work items into contiguous ranges and runs them
+ *        concurrently, returning once every range has finished.
+ *
+ * @param count Number of work items.
+ * @param threads Maximum number of workers; 0 uses ntthreads().
+ * @param fn Callback run once per range.
+ * @param ctx Context passed to every `fn` call.
+ * @return Number of workers actually used.
+ */
+unsigned ntparallel( size_t count , unsigned threads , ntrange_f fn , void *ctx );
+
+#endif // NTTHREAD_H
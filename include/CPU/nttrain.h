@@ -11,11 +11,60 @@
 #define NTTRAIN_H
 
 #include "ntcore.h"
+#include <stddef.h>
 
 typedef data_t precision_t;
 typedef uint64_t sample_t, attempts_t;
 
 
+/**
+ * @brief Source of training samples, pulled one batch at a time.
+ *
+ * Lets training read samples from somewhere other than
+ * traindata_t::in / traindata_t::results -- e.g. a background loader.
+ */
+typedef struct sampler_s {
+    /**
+     * Hands over the next batch through `in` and `results` (one row
+     * pointer per sample) and returns its size, or returns 0 once the
+     * current epoch has been fully handed over. The rows stay valid until
+     * the following call.
+     */
+    sample_t    ( *next )( void *ctx , data_t ***in , data_t ***results );
+    void        *ctx;       /**< Context passed to every `next` call. */
+} sampler_s;
+
+/**
+ * @brief Progress of a training call, as reported to hooks.
+ *
+ * Rates and times cover the current call to backpropagation() from its
+ * start; `error` covers the current epoch only.
+ */
+typedef struct trainstats_s {
+    attempts_t  epoch;              /**< Epochs run so far in this call, counting the current one. */
+    sample_t    batch;              /**< Batches completed so far in the current epoch. */
+    sample_t    samples;            /**< Samples processed so far in the current epoch. */
+    precision_t error;              /**< Cumulative absolute error of the current epoch so far. */
+    precision_t learning_rate;      /**< Learning rate in use. */
+    double      elapsed;            /**< Seconds since training started. */
+    double      samples_per_second; /**< Samples processed per second since training started. */
+    uint64_t    flops;              /**< Floating-point operations spent updating weights and biases since training started, counted as they run (see trainer_s::flops). */
+} trainstats_s;
+
+/**
+ * @brief Callbacks run by training as it progresses, chainable.
+ *
+ * Lets other modules observe or act on a network while it trains --
+ * e.g. logging throughput or checkpointing it -- without training
+ * knowing about them. Either callback may be NULL.
+ */
+typedef struct trainhook_s {
+    void                ( *epoch )( net_s *net , const trainstats_s *stats , void *ctx );   /**< Called after every epoch. */
+    void                ( *batch )( net_s *net , const trainstats_s *stats , void *ctx );   /**< Called after every batch handed over by traindata_t::sampler, or after every epoch without one. */
+    void                *ctx;   /**< Context passed to every call. */
+    struct trainhook_s  *next;  /**< Next hook in the chain, or NULL. */
+} trainhook_s;
+
 /**
  * @brief Structure to hold training dataset and parameters.
  */
@@ -26,10 +75,49 @@ typedef struct traindata_t {
     attempts_t max_attempts;    /**< Maximum number of training iterations. */
     data_t **in;                /**< Input data for training samples. */
     data_t **results;           /**< Expected output results for training samples. */
+    input_t inputs;             /**< Values per input row. */
+    uint16_t outputs;           /**< Values per expected output row. */
+    data_t *in_block;           /**< Contiguous row-major matrix every `in` row points into. */
+    data_t *results_block;      /**< Contiguous row-major matrix every `results` row points into. */
+    void *map;                  /**< Read-only file mapping backing both blocks, if any. */
+    size_t map_size;            /**< Size, in bytes, of `map`. */
+    sampler_s *sampler;         /**< Optional sample source used instead of `in` and `results`. */
+    trainhook_s *hook;          /**< Optional chain of hooks run as training progresses. */
 } traindata_t;
 
 /**
- * @brief Allocates memory for training data arrays.
+ * @brief Persistent training state of one network, for sample-by-sample
+ *        (online) updates.
+ *
+ * Holds everything a training step needs -- the network's reverse
+ * adjacency index, its delta scratch and its bound input buffer -- so
+ * that steps allocate nothing. Fields other than `learning_rate`, `cache`
+ * and `easy` are managed by newtrainer(), freetrainer(), freezelayer() and
+ * freezeneuron().
+ */
+typedef struct trainer_s {
+    net_s               *net;           /**< Network being trained; its `in` is bound to `in`. */
+    precision_t         learning_rate;  /**< Learning rate; may be changed between steps. */
+    data_t              *in;            /**< Input buffer every `net_s::in` points into. */
+    precision_t         *delta;         /**< Delta of every neuron, by flat index. */
+    uint32_t            *first;         /**< Flat index of each layer's first neuron, size `layers + 1`. */
+    uint32_t            *start;         /**< Offset of each neuron's reverse edge list, size `first[layers] + 1`. */
+    struct revedge_s    *edges;         /**< Reverse edges, grouped by source neuron. */
+    weight_t            *weights;       /**< Weight block the reverse edges point into. */
+    uint32_t            *source;        /**< Flat index of the neuron feeding each input, or `UINT32_MAX`, every neuron's inputs back to back. */
+    size_t              *source_at;     /**< Offset of each neuron's first input in `source`, size `first[layers] + 1`. */
+    precision_t         density;        /**< Running fraction of nonzero deltas, which selects the backward pass. */
+    uint8_t             *frozen;        /**< Nonzero for every neuron whose weights and bias are not updated, by flat index. */
+    layer_t             shallowest;     /**< Shallowest layer holding a trainable neuron; `net_s::layers` if none does. */
+    uint8_t             cache;          /**< Nonzero lets trainepochs() cache the outputs of the frozen layers below `shallowest`. */
+    precision_t         easy;           /**< Per-sample absolute error below which a sample counts as learned and trainepochs() mines for hard ones; 0 disables. */
+    precision_t         loss;           /**< Absolute error of the last sample run. */
+    uint64_t            flops;          /**< Floating-point operations spent on weight and bias updates so far: two per input and two for the bias of every row actually updated. */
+} trainer_s;
+
+/**
+ * @brief Allocates memory for training data arrays, as two contiguous
+ *        row-major matrices.
  *
  * @param train_data Pointer to a traindata_t instance with `samples`
  *                    already set.
@@ -37,6 +125,68 @@ typedef struct traindata_t {
  */
 void newtraindata( traindata_t *train_data , net_s *net );
 
+/**
+ * @brief Prepares a network for step-by-step training.
+ *
+ * @param trainer Trainer to initialize.
+ * @param net Built network to train; its inputs stay bound to the
+ *            trainer until freetrainer().
+ * @param learning_rate Learning rate of every step.
+ * @return `trainer`, or NULL if its memory could not be allocated.
+ */
+trainer_s *newtrainer( trainer_s *trainer , net_s *net , precision_t learning_rate );
+
+/**
+ * @brief Trains the network on a single sample: one forward and one
+ *        backward pass, with no allocation.
+ *
+ * @param trainer Trainer returned by newtrainer().
+ * @param x Input row, `net_s::inputs` values.
+ * @param y Expected output row, one value per output neuron.
+ * @return The sample's absolute output error, before the update, or -1
+ *         if the network's weights are shared with a clone and could not
+ *         be made its own.
+ */
+precision_t train_step( trainer_s *trainer , const data_t *x , const data_t *y );
+
+/**
+ * @brief Freezes or unfreezes every neuron of a layer.
+ *
+ * @param trainer Trainer returned by newtrainer().
+ * @param layer Layer index.
+ * @param frozen Nonzero stops the layer's weights and biases from being
+ *               updated; zero makes them trainable again.
+ */
+void freezelayer( trainer_s *trainer , layer_t layer , uint8_t frozen );
+
+/**
+ * @brief Freezes or unfreezes a single neuron.
+ *
+ * @param trainer Trainer returned by newtrainer().
+ * @param layer Layer index.
+ * @param neuron Neuron index within the layer.
+ * @param frozen Nonzero stops the neuron's weights and bias from being
+ *               updated; zero makes them trainable again.
+ */
+void freezeneuron( trainer_s *trainer , layer_t layer , uint16_t neuron , uint8_t frozen );
+
+/**
+ * @brief Trains a network through its trainer, epoch by epoch, over a
+ *        training set.
+ *
+ * @param trainer Trainer returned by newtrainer().
+ * @param train_data Pointer to the training data.
+ * @return Number of epochs performed.
+ */
+attempts_t trainepochs( trainer_s *trainer , traindata_t *train_data );
+
+/**
+ * @brief Releases a trainer's memory and unbinds its network's inputs.
+ *
+ * @param trainer Trainer returned by newtrainer().
+ */
+void freetrainer( trainer_s *trainer );
+
 /**
  * @brief Trains a network using backpropagation.
  *
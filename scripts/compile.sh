@@ -101,6 +101,14 @@ ls $PROJECT_LOCATION/obj/*.o >/dev/null  2>&1 && ar rcs "$PROJECT_LOCATION/lib/l
 ls obj/*.o >/dev/null  2>&1 && ar rcs "$PROJECT_LOCATION/lib/libNTIC.a" obj/*.o && LDFLAGS+=("-lNTIC") && rm -f obj/*.o
 LDFLAGS+=("-lm")
 
+# Link POSIX threads only when a compiled NeuroTIC source requires them
+for obj in "${NTIC_INCLUDES[@]}"; do
+    for DIR in "src/" "src/$PLATFORM/"; do
+        SRC="$DIR/${obj%.h}.c"
+        [ -f "$SRC" ] && grep -q '^\s*#include\s*<pthread.h>' "$SRC" && [[ ! " ${LDFLAGS[*]} " =~ " -pthread " ]] && LDFLAGS+=("-pthread")
+    done
+done
+
 # Link final executable
 $CC $CFLAGS "$PROJECT_LOCATION/$PROJECT_NAME.c" -o "$PROJECT_LOCATION/$PROJECT_NAME" -L"$PROJECT_LOCATION/lib" ${LDFLAGS[@]}
 
@@ -82,6 +82,20 @@ static float lrelu( float x ){
 static float lrelu_d( float x ){
     return x > 0.0f ? 1.0f : NTACT_LRELU_ALPHA;
 }
+//SOFTMAX
+// [!]  Softmax is a layer-wide function: this entry only yields the
+//      unnormalized exponential. feedforward() normalizes every softmax
+//      neuron of a layer against the others in that same layer.
+// [!]  Its derivative is never evaluated per neuron: at the output layer
+//      training uses the fused softmax/cross-entropy gradient, and in a
+//      hidden layer the diagonal term out * ( 1 - out ) is taken from the
+//      neuron's output instead.
+static float softmax( float x ){
+    return expf( x );
+}
+static float softmax_d( float x ){
+    return x= 1.0f;
+}
 // ...
 /** @endcode */
 
@@ -98,7 +112,8 @@ float ( *ntact_activation[NTACT_TOTAL_FUNCTIONS][2] )( float )={
     [NTACT_SIGMOID]= { sigmoid , sigmoid_d },
     [NTACT_TANH]   = { hyptan  , hyptan_d  },
     [NTACT_RELU]   = { relu    , relu_d    },
-    [NTACT_LRELU]  = { lrelu   , lrelu_d   }
+    [NTACT_LRELU]  = { lrelu   , lrelu_d   },
+    [NTACT_SOFTMAX]= { softmax , softmax_d }
 //  [NTACT_<NAME>]= { <func> , <func>_d }
 };
 
@@ -115,6 +130,7 @@ float ntact_rand_range[NTACT_TOTAL_FUNCTIONS][2]={
     [NTACT_SIGMOID]= { -1.0f , 1.0f },
     [NTACT_TANH]   = { -1.0f , 1.0f },
     [NTACT_RELU]   = { -0.5f , 0.5f },
-    [NTACT_LRELU]  = { -0.5f , 0.5f }
+    [NTACT_LRELU]  = { -0.5f , 0.5f },
+    [NTACT_SOFTMAX]= { -1.0f , 1.0f }
 //  [NTACT_<NAME>]= { <min> , <max> }
 };
\ No newline at end of file
@@ -3,7 +3,7 @@
  * @brief Implementation of network construction functions.
  *
  * Provides memory allocation and pointer setup for neurons, input/output references, and inter-layer buffers.  
- * Uses memtrack() to manage memory safely.
+ * Uses memtrack() to manage memory safely, carving each network's arrays out of a few arena slabs.
  * 
  * @author Oscar Sotomayor
  * @date 2026
@@ -16,6 +16,183 @@
 #include <string.h>
 #include <stdio.h>
 
+/**
+ * @retval 1 element `k` of `net->bff[i][j]` is the output of neuron
+ *           `net->nn[*layer][*index]`.
+ * @retval 0 it is not a neuron output ('I' sources and unresolved
+ *           elements), or the alias chain could not be followed.
+ *
+ * @details
+ * Resolves, from the wiring descriptors alone, which neuron a single
+ * buffer element reads from -- following the same rules buildnet() used to
+ * create that element, including chains of top-level 'N' aliases.
+ */
+int resolvesource( const net_s *net , layer_t i , index_t j , input_t k , layer_t *layer , uint16_t *index ){
+    for( uint32_t depth= 0 ; depth <= (uint32_t)net->layers * 256 ; depth++ ){
+        if( i >= net->layers - 1 || j >= net->wiring[i].arrays ) return 0;
+        switch( net->wiring[i].array_type[j] ){
+            case 'M':
+                switch( net->wiring[i].src_type[j][k] ){
+                    case 'N':
+                        *layer= net->wiring[i].src_layer[j][k];
+                        *index= net->wiring[i].src_index[j][k];
+                        return *layer < net->layers && *index < net->neurons[*layer];
+                    case 'O':
+                        *layer= net->layers - 1;
+                        *index= net->wiring[i].src_index[j][k];
+                        return *index < net->neurons[*layer];
+                    default:
+                        return 0;
+                }
+            case 'N':{
+                layer_t alias_layer= net->wiring[i].src_layer[j][0];
+                j= (index_t)net->wiring[i].src_index[j][0];
+                i= alias_layer;
+                break;
+            }
+            case 'O':
+                *layer= net->layers - 1;
+                *index= (uint16_t)k;
+                return k < net->neurons[*layer];
+            default:
+                return 0;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @details
+ * Whether every neuron of layer `i` reads the same, already resolved,
+ * input references, none of them the output of a neuron in layer `i` or
+ * a later one (see resolvesource()): the packed path gathers the inputs
+ * before any neuron runs, so it could not see an output the same sweep
+ * updates.
+ */
+static uint8_t sharedinputs( const net_s *net , layer_t i ){
+    layer_t layer;
+    uint16_t index;
+    for( uint16_t j= 1 ; j < net->neurons[i] ; j++ ) if( net->nn[i][j].in != net->nn[i][0].in || net->nn[i][j].inputs != net->nn[i][0].inputs ) return 0;
+    if( i ) for( input_t k= 0 ; k < net->nn[i][0].inputs ; k++ ) if( resolvesource( net , i - 1 , net->nn[i][0].bff_idx , k , &layer , &index ) && layer >= i ) return 0;
+    return 1;
+}
+
+/**
+ * @details
+ * Fills layer `i`'s packed view when its neurons share one input set and
+ * their weight rows are evenly spaced -- the weight block places each row
+ * @ref ARENA_SIZE bytes after the previous one. The row stride is padded
+ * to @ref ARENA_ALIGN, keeping every row equally aligned.
+ */
+static void packlayer( net_s *net , layer_t i ){
+    neuron_s *nn= net->nn[i];
+    const input_t stride= (input_t)( ARENA_SIZE( nn[0].inputs ? nn[0].inputs * sizeof( weight_t ) : 1 ) / sizeof( weight_t ) );
+    if( !net->layer || !sharedinputs( net , i ) ) return;
+    for( uint16_t j= 1 ; j < net->neurons[i] ; j++ ) if( nn[j].w != nn[0].w + (size_t)j * stride ) return;
+    data_t *x= arenaalloc( (void *)net , nn[0].inputs * sizeof( data_t ) );
+    if( x ) net->layer[i]= (layer_s){ .in= nn[0].in , .inputs= nn[0].inputs , .stride= stride , .w= nn[0].w , .x= x };
+}
+
+/**
+ * @details
+ * The first half of buildnet(): resolves net_s::wiring into net_s::bff,
+ * out of an arena slab sized by a planning pass, then points every
+ * neuron from layer 1 onward at its selected buffer.
+ */
+static void resolvebuffers( net_s *net ){
+    if( net->layers > 1 ){
+        size_t plan= 0;
+        for( layer_t i= 0 ; i < net->layers - 1 ; i++ ){
+            plan+= ARENA_SIZE( net->wiring[i].arrays * sizeof( data_t ** ) );
+            for( input_t j= 0 ; j < net->wiring[i].arrays ; j++ ) if( net->wiring[i].array_type[j] == 'M' ) plan+= ARENA_SIZE( net->wiring[i].size[j] * sizeof( data_t * ) );
+        }
+        createarena( (void *)net , plan );
+        for( layer_t i= 0 ; i < net->layers - 1 ; i++ ){
+            net->bff[i]= arenaalloc( (void *)net , net->wiring[i].arrays * sizeof( data_t ** ) );
+            for( input_t j= 0 ; j < net->wiring[i].arrays ; j++ ){
+                if( net->wiring[i].array_type[j] == 'M' ){
+                    net->bff[i][j]= arenaalloc( (void *)net , net->wiring[i].size[j] * sizeof( data_t * ) );
+                    for( uint32_t k= 0 ; k < net->wiring[i].size[j] ; k++ ){
+                        switch( net->wiring[i].src_type[j][k] ){
+                            case 'N':
+                                net->bff[i][j][k]= &net->nn[net->wiring[i].src_layer[j][k]][net->wiring[i].src_index[j][k]].out;
+                                break;
+                            case 'O':
+                                net->bff[i][j][k]= net->out[net->wiring[i].src_index[j][k]];
+                                break;
+                            default:
+                                net->bff[i][j][k]= NULL;
+                                break;
+                        }
+                    }
+                }
+            }
+        }
+        for( layer_t i= 0 ; i < net->layers - 1 ; i++) for( uint16_t j = 0 ; j < net->wiring[i].arrays ; j++) switch( net->wiring[i].array_type[j] ){
+            case 'M':
+                break;
+            case 'N':
+                net->bff[i][j]= net->bff[net->wiring[i].src_layer[j][0]][net->wiring[i].src_index[j][0]];
+                net->wiring[i].size[j]= net->wiring[net->wiring[i].src_layer[j][0]].size[net->wiring[i].src_index[j][0]];
+                break;
+            case 'I':
+                net->bff[i][j]= net->in;
+                net->wiring[i].size[j]= net->inputs;
+                break;
+            case 'O':
+                net->bff[i][j]= net->out;
+                net->wiring[i].size[j]= net->neurons[net->layers - 1];
+                break;
+            default:
+                net->bff[i][j]= NULL;
+                net->wiring[i].size[j]= 1;
+                break;
+        }
+    }
+    for( layer_t i= 1 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
+        net->nn[i][j].inputs= net->wiring[i - 1].size[net->nn[i][j].bff_idx];
+        net->nn[i][j].in= net->bff[i - 1][net->nn[i][j].bff_idx];
+    }
+}
+
+/**
+ * @details
+ * Size of the weight block: every neuron's row, padded to
+ * @ref ARENA_ALIGN.
+ */
+static size_t weightsize( const net_s *net ){
+    size_t size= 0;
+    for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) size+= ARENA_SIZE( net->nn[i][j].inputs * sizeof( weight_t ) );
+    return size;
+}
+
+/**
+ * @details
+ * Points every neuron_s::w into the weight block `w`, row after row in
+ * the order the forward pass visits them, each row padded to
+ * @ref ARENA_ALIGN. A NULL block leaves every row NULL.
+ */
+static void carveweights( net_s *net , weight_t *w ){
+    for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
+        net->nn[i][j].w= w;
+        if( w ) w+= ARENA_SIZE( net->nn[i][j].inputs * sizeof( weight_t ) ) / sizeof( weight_t );
+    }
+}
+
+/**
+ * @details
+ * Allocates net_s::layer and the packed inputs of every layer that gets
+ * one from a single arena slab, then fills each layer's view with
+ * packlayer().
+ */
+static void packlayers( net_s *net ){
+    size_t plan= ARENA_SIZE( net->layers * sizeof( layer_s ) );
+    for( layer_t i= 0 ; i < net->layers ; i++ ) if( sharedinputs( net , i ) ) plan+= ARENA_SIZE( net->nn[i][0].inputs * sizeof( data_t ) );
+    createarena( (void *)net , plan );
+    net->layer= arenaalloc( (void *)net , net->layers * sizeof( layer_s ) );
+    for( layer_t i= 0 ; i < net->layers ; i++ ) packlayer( net , i );
+}
+
 /**
  * @retval NULL
  *  - `net` or `neurons_per_layer` is NULL.
@@ -33,6 +210,9 @@
  * When net_s::layers is greater than 1, allocates one net_s::wiring descriptor
  * per layer transition, and net_s::bff's outer array (one slot per layer
  * transition, each left as `NULL`).
+ *
+ * Every one of these arrays is carved from a single arena slab, sized by
+ * adding up their @ref ARENA_SIZE before anything is allocated.
  */
 struct net_s *newnet( net_s *net , uint16_t *neurons_per_layer , layer_t layers_size ){
     if( !net || !neurons_per_layer || net->layers < 1 || layers_size != net->layers ) return NULL;
@@ -41,19 +221,24 @@ struct net_s *newnet( net_s *net , uint16_t *neurons_per_layer , layer_t layers_
     net->nn= NULL;
     net->bff= NULL;
     net->out= NULL;
-    net->neurons= createregister( (void *)net , calloc( net->layers , sizeof( uint16_t ) ) );
+    net->layer= NULL;
+    size_t plan= ARENA_SIZE( net->layers * sizeof( uint16_t ) ) + ARENA_SIZE( net->layers * sizeof( neuron_s * ) ) + ARENA_SIZE( net->inputs * sizeof( data_t * ) ) + ARENA_SIZE( neurons_per_layer[net->layers - 1] * sizeof( data_t * ) );
+    for( layer_t i= 0 ; i < net->layers ; i++ ) plan+= ARENA_SIZE( neurons_per_layer[i] * sizeof( neuron_s ) );
+    if( net->layers > 1 ) plan+= ARENA_SIZE( (net->layers - 1) * sizeof( wiring_s ) ) + ARENA_SIZE( (net->layers - 1) * sizeof( data_t *** ) );
+    createarena( (void *)net , plan );
+    net->neurons= arenaalloc( (void *)net , net->layers * sizeof( uint16_t ) );
     memcpy( net->neurons , neurons_per_layer, net->layers * sizeof( uint16_t ) );
-    net->nn= createregister( (void *)net , calloc( net->layers , sizeof( neuron_s * ) ) );
-    for( uint16_t i = 0 ; i < net->layers ; i++ ) net->nn[i]= createregister( (void *)net , calloc( net->neurons[i] , sizeof( neuron_s ) ) );
-    net->in= createregister( (void *)net , calloc( net->inputs , sizeof( data_t * ) ) );
+    net->nn= arenaalloc( (void *)net , net->layers * sizeof( neuron_s * ) );
+    for( uint16_t i = 0 ; i < net->layers ; i++ ) net->nn[i]= arenaalloc( (void *)net , net->neurons[i] * sizeof( neuron_s ) );
+    net->in= arenaalloc( (void *)net , net->inputs * sizeof( data_t * ) );
     for( uint16_t i = 0 ; i < net->neurons[0] ; i++ ){
         net->nn[0][i].in= net->in;
         net->nn[0][i].inputs= net->inputs;
     }
-    net->out= createregister( (void *)net , calloc( net->neurons[net->layers - 1] , sizeof( data_t * ) ) );
+    net->out= arenaalloc( (void *)net , net->neurons[net->layers - 1] * sizeof( data_t * ) );
     for( uint16_t i = 0 ; i < net->neurons[net->layers - 1] ; i++ ) net->out[i]= &net->nn[net->layers - 1][i].out;
-    net->wiring= net->layers > 1 ? createregister( (void *)net , calloc( net->layers - 1 , sizeof( wiring_s ) ) ) : NULL;
-    net->bff= net->layers > 1 ? createregister( (void *)net , calloc( net->layers - 1 , sizeof( data_t *** ) ) ) : NULL;
+    net->wiring= net->layers > 1 ? arenaalloc( (void *)net , (net->layers - 1) * sizeof( wiring_s ) ) : NULL;
+    net->bff= net->layers > 1 ? arenaalloc( (void *)net , (net->layers - 1) * sizeof( data_t *** ) ) : NULL;
     for( layer_t i= 0 ; i < net->layers - 1 ; i++ ) net->bff[i]= NULL;
     return net;
 }
@@ -79,6 +264,15 @@ struct net_s *newnet( net_s *net , uint16_t *neurons_per_layer , layer_t layers_
  * Finally, allocates neuron_s::w for every neuron in the network according to its
  * (resolved or pre-existing) neuron_s::inputs.
  *
+ * The buffer arrays come from one arena slab sized by a planning pass. The
+ * weights come from one shared block (see createshared()), so those of
+ * adjacent neurons sit back to back in memory, in the same order the
+ * forward pass visits them, and clonenet() can hand the whole block to a
+ * clone. Every layer whose neurons share one input set, read only from
+ * the inputs or earlier layers, then gets a packed layer_s view over
+ * those rows (see packlayer()); the others keep a zeroed view and are
+ * evaluated neuron by neuron.
+ *
  * @note
  * wiring_s::array_type (second pass):
  *      - 'I': Alias to net_s::in.
@@ -96,55 +290,125 @@ struct net_s *newnet( net_s *net , uint16_t *neurons_per_layer , layer_t layers_
 struct net_s *buildnet( net_s *net ){ 
     if( !net ) return net;
     if( !net->neurons ) NULL;
-    if( net->layers > 1 ){
-        for( layer_t i= 0 ; i < net->layers - 1 ; i++ ){
-            net->bff[i]= createregister( (void *)net , calloc( net->wiring[i].arrays , sizeof( data_t ** ) ) );
-            for( input_t j= 0 ; j < net->wiring[i].arrays ; j++ ){
-                if( net->wiring[i].array_type[j] == 'M' ){
-                    net->bff[i][j]= createregister( (void *)net , calloc( net->wiring[i].size[j] , sizeof( data_t * ) ) );
-                    for( uint32_t k= 0 ; k < net->wiring[i].size[j] ; k++ ){
-                        switch( net->wiring[i].src_type[j][k] ){
-                            case 'N':
-                                net->bff[i][j][k]= &net->nn[net->wiring[i].src_layer[j][k]][net->wiring[i].src_index[j][k]].out;
-                                break;
-                            case 'O':
-                                net->bff[i][j][k]= net->out[net->wiring[i].src_index[j][k]];
-                                break;
-                            default:
-                                net->bff[i][j][k]= NULL;
-                                break;
-                        }
-                    }
-                }
-            }
-        }
-        for( layer_t i= 0 ; i < net->layers - 1 ; i++) for( uint16_t j = 0 ; j < net->wiring[i].arrays ; j++) switch( net->wiring[i].array_type[j] ){
-            case 'M':
-                break;
-            case 'N':
-                net->bff[i][j]= net->bff[net->wiring[i].src_layer[j][0]][net->wiring[i].src_index[j][0]];
-                net->wiring[i].size[j]= net->wiring[net->wiring[i].src_layer[j][0]].size[net->wiring[i].src_index[j][0]];
-                break;
-            case 'I':
-                net->bff[i][j]= net->in;
-                net->wiring[i].size[j]= net->inputs;
-                break;
-            case 'O':
-                net->bff[i][j]= net->out;
-                net->wiring[i].size[j]= net->neurons[net->layers - 1];
-                break;
-            default:
-                net->bff[i][j]= NULL;
-                net->wiring[i].size[j]= 1;
-                break;
-        }
+    resolvebuffers( net );
+    carveweights( net , createshared( (void *)net , weightsize( net ) ) );
+    packlayers( net );
+    return net;
+}
+
+/**
+ * @retval NULL
+ *  - `net` or `weights` is NULL, or net_s::neurons has not been allocated.
+ *  - the resolved rows do not fit in `size` bytes.
+ *
+ * @details
+ * buildnet() over a weight block that already holds the network's
+ * weights -- laid out as buildnet() would, each row padded to
+ * @ref ARENA_ALIGN -- instead of a freshly allocated one. The block must
+ * be a shared block of `net` (see createshared() and createsharedmap()),
+ * so that clonenet() and ownweights() can handle it like any other.
+ */
+struct net_s *buildshared( net_s *net , weight_t *weights , size_t size ){
+    if( !net || !weights || !net->neurons ) return NULL;
+    resolvebuffers( net );
+    if( weightsize( net ) > size ) return NULL;
+    carveweights( net , weights );
+    packlayers( net );
+    return net;
+}
+
+/**
+ * @retval NULL
+ *  - `clone` or `net` is NULL, or `net` has not been built.
+ *  - the clone's structures could not be allocated.
+ *
+ * @details
+ * Builds `clone` as a copy of `net`: same layer sizes, activations,
+ * buffer selections, biases and external input references. The wiring
+ * descriptors are shared, not copied, and so is the weight block: the
+ * clone becomes one more holder of it (see shareblock()), so cloning
+ * costs the neuron and buffer arrays, not the weights. Whichever holder
+ * is first modified takes a private copy with ownweights(); initnet(),
+ * evolvenet() and the trainers all do so before writing, and every
+ * training function again after each epoch hook, so a clone made by a
+ * hook stays a snapshot. A trainer made before cloning checks before every
+ * train_step() and trainepochs() call too, and moves its reverse edges
+ * onto the copy.
+ *
+ * @warning
+ * `net` must outlive the clone, since their wiring is shared.
+ */
+struct net_s *clonenet( net_s *clone , net_s *net ){
+    if( !clone || !net || !net->nn ) return NULL;
+    weight_t *shared= net->nn[0][0].w;
+    *clone= (net_s){ .inputs= net->inputs , .layers= net->layers };
+    if( !newnet( clone , net->neurons , net->layers ) ) return NULL;
+    for( layer_t i= 0 ; i + 1 < net->layers ; i++ ) clone->wiring[i]= net->wiring[i];
+    for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
+        clone->nn[i][j].bff_idx= net->nn[i][j].bff_idx;
+        clone->nn[i][j].fn= net->nn[i][j].fn;
+        clone->nn[i][j].b= net->nn[i][j].b;
     }
-    for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++){
-        if( i ){
-            net->nn[i][j].inputs= net->wiring[i - 1].size[net->nn[i][j].bff_idx];
-            net->nn[i][j].in= net->bff[i - 1][net->nn[i][j].bff_idx];
-        }
-        net->nn[i][j].w= createregister( (void *)net , calloc( net->nn[i][j].inputs , sizeof( weight_t ) ) );
+    resolvebuffers( clone );
+    if( shared && !shareblock( (void *)clone , (void *)net , shared ) ) return NULL;
+    for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) clone->nn[i][j].w= shared ? shared + ( net->nn[i][j].w - shared ) : NULL;
+    packlayers( clone );
+    for( input_t k= 0 ; k < net->inputs ; k++ ) clone->in[k]= net->in[k];
+    return clone;
+}
+
+/**
+ * @retval NULL the private copy could not be allocated; `net` still
+ *              reads the shared weights.
+ *
+ * @details
+ * If `net`'s weight block is held by any other network, copies it into a
+ * block of `net`'s own -- placed like the rest of its memory -- repoints
+ * every neuron_s::w and layer_s::w into the copy and drops `net`'s
+ * reference to the shared one. Otherwise does nothing, so it is cheap to
+ * call before every write.
+ *
+ * @warning
+ * Other pointers into the old weights are not updated. A trainer's
+ * reverse edges are an exception: the trainer moves them onto the copy
+ * before its next step.
+ */
+struct net_s *ownweights( net_s *net ){
+    if( !net || !net->nn ) return NULL;
+    weight_t *shared= net->nn[0][0].w;
+    if( sharecount( (void *)net , shared ) < 2 ) return net;
+    const size_t size= weightsize( net );
+    weight_t *w= createshared( (void *)net , size );
+    if( !w ) return NULL;
+    memcpy( w , shared , size );
+    for( layer_t i= 0 ; i < net->layers ; i++ ){
+        for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) net->nn[i][j].w= w + ( net->nn[i][j].w - shared );
+        if( net->layer && net->layer[i].w ) net->layer[i].w= w + ( net->layer[i].w - shared );
     }
+    deleteblock( (void *)net , shared );
     return net;
-}
\ No newline at end of file
+}
+
+/**
+ * @retval NULL
+ *  - `replica` or `net` is NULL.
+ *  - the replica could not be placed or built.
+ *
+ * @details
+ * Builds `replica` as a copy of `net` whose memory follows `placement`:
+ * a clonenet() that immediately takes its own weights, so everything a
+ * forward pass touches -- neurons, buffers, weights and packed layer
+ * views -- belongs to the replica. With one replica bound to each NUMA
+ * node, inference threads read only local memory (see currentnode()).
+ * The wiring descriptors are shared, not copied, so `net` must outlive
+ * the replica.
+ *
+ * The replica is a snapshot: later changes to `net`'s weights are not
+ * reflected in it.
+ */
+struct net_s *replicanet( net_s *replica , net_s *net , const placement_s *placement ){
+    if( !replica || !net ) return NULL;
+    if( placement && placeowner( (void *)replica , placement ) ) return NULL;
+    if( !clonenet( replica , net ) ) return NULL;
+    return ownweights( replica );
+}
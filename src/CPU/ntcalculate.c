@@ -4,7 +4,9 @@
  *
  * @details
  * Provides weighted sum, activation, and full forward propagation.  
- * Assumes sequential layer-by-layer calculation.
+ * Assumes sequential layer-by-layer calculation. Layers with a packed
+ * layer_s view are evaluated as a dense matrix-vector product over
+ * their gathered inputs.
  * 
  * @author Oscar Sotomayor
  * @date 2026
@@ -13,6 +15,7 @@
 #include "ntcalculate.h"
 #include "ntactivation.h"
 #include <stdlib.h>
+#include <math.h>
 
 /**
  * @details
@@ -41,29 +44,187 @@ data_t activate( neuron_s *neuron ){
     return neuron->out= ntact_activation[neuron->fn][0]( weighing( neuron ) );
 }
 
+/**
+ * @retval NULL `net` has no packed view of `layer` (see layer_s).
+ *
+ * @details
+ * The gathered inputs are those of the last forward pass that evaluated
+ * `layer`; they go stale as soon as any earlier output changes.
+ */
+const data_t *layerinputs( const net_s *net , layer_t layer ){
+    return net->layer && net->layer[layer].w ? net->layer[layer].x : NULL;
+}
+
+/**
+ * @details
+ * Same sum as weighing(), in the same order -- bias first, then inputs
+ * ascending -- so both give bit-identical results. On a packed layer the
+ * inputs come from layer_s::x and the weights from the layer's matrix,
+ * both contiguous, instead of through one pointer per input.
+ */
+data_t layerweighing( net_s *net , layer_t layer , uint16_t neuron ){
+    const data_t *restrict x= layerinputs( net , layer );
+    if( !x ) return weighing( &net->nn[layer][neuron] );
+    const weight_t *restrict w= net->layer[layer].w + (size_t)neuron * net->layer[layer].stride;
+    data_t wgh= net->nn[layer][neuron].b;
+    for( input_t i= 0 ; i < net->layer[layer].inputs ; i++ ) wgh+= x[i] * w[i];
+    return wgh;
+}
+
+
+/**
+ * @details
+ * Normalizes every softmax neuron of `layer` against the others, given
+ * that each one's `neuron_s::out` currently holds its pre-activation
+ * value and `max` is the largest of them. The maximum is subtracted before
+ * exponentiating, so large pre-activations cannot overflow.
+ */
+static void softmaxlayer( neuron_s *layer , uint16_t neurons , data_t max ){
+    data_t sum= 0.0f;
+    for( uint16_t j= 0 ; j < neurons ; j++ ) if( layer[j].fn == NTACT_SOFTMAX ) sum+= layer[j].out= expf( layer[j].out - max );
+    sum= 1.0f / sum;
+    for( uint16_t j= 0 ; j < neurons ; j++ ) if( layer[j].fn == NTACT_SOFTMAX ) layer[j].out*= sum;
+}
+
+/**
+ * @details
+ * Re-resolves any `'I'`-typed element nested inside neuron `j` of layer
+ * `i`'s selected `'M'` buffer against the network's current `net_s::in`
+ * -- every other wiring reference was already resolved once, permanently,
+ * by `buildnet()`.
+ */
+static void refreshinputs( net_s *net , layer_t i , uint16_t j ){
+    if( i && net->wiring[i - 1].array_type[net->nn[i][j].bff_idx] == 'M' ) for( uint32_t k= 0 ; k < net->nn[i][j].inputs ; k++ ) switch( net->wiring[i-1].src_type[net->nn[i][j].bff_idx][k] ){
+        case 'I':
+            net->bff[i - 1][net->nn[i][j].bff_idx][k]= net->in[net->wiring[i - 1].src_index[net->nn[i][j].bff_idx][k]];
+            break;
+    }
+}
+
+/**
+ * @details
+ * Prepares layer `i`'s inputs for evaluation. On a packed layer the
+ * shared input set is refreshed once and its values gathered into
+ * layer_s::x, so each neuron's sum reads one contiguous vector instead
+ * of dereferencing every input again; returns 1. Otherwise returns 0 and
+ * each neuron is refreshed on its own as it is evaluated.
+ */
+static uint8_t gatherinputs( net_s *net , layer_t i ){
+    if( !layerinputs( net , i ) ) return 0;
+    refreshinputs( net , i , 0 );
+    layer_s *layer= &net->layer[i];
+    for( input_t k= 0 ; k < layer->inputs ; k++ ) layer->x[k]= *layer->in[k];
+    return 1;
+}
+
+/**
+ * @details
+ * Evaluates every neuron of layer `i`, refreshing nested `'I'` elements
+ * first (see refreshinputs()) -- once for a packed layer, whose inputs
+ * are gathered by gatherinputs(), or per neuron otherwise.
+ *
+ * Softmax neurons only have their pre-activation stored while the layer
+ * is swept; they are normalized together once the sweep ends.
+ */
+static void forwardlayer( net_s *net , layer_t i ){
+    uint8_t softmax= 0;
+    data_t max= -INFINITY;
+    const uint8_t packed= gatherinputs( net , i );
+    for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
+        neuron_s *neuron= &net->nn[i][j];
+        if( !packed ) refreshinputs( net , i , j );
+        const data_t wgh= layerweighing( net , i , j );
+        if( neuron->fn == NTACT_SOFTMAX ){
+            softmax= 1;
+            if( ( neuron->out= wgh ) > max ) max= wgh;
+        } else neuron->out= ntact_activation[neuron->fn][0]( wgh );
+    }
+    if( softmax ) softmaxlayer( net->nn[i] , net->neurons[i] , max );
+}
+
+/**
+ * @details
+ * Inserts output `j`, valued `v`, into a descending top-`k` list holding
+ * `*ranked` entries so far. An output equal to one already listed is
+ * placed after it.
+ */
+static void rankoutput( data_t *value , uint16_t *rank , uint16_t *ranked , uint16_t k , data_t v , uint16_t j ){
+    uint16_t p= *ranked < k ? (*ranked)++ : k;
+    for( ; p && value[p - 1] < v ; p-- ) if( p < k ){
+        value[p]= value[p - 1];
+        rank[p]= rank[p - 1];
+    }
+    if( p < k ){
+        value[p]= v;
+        rank[p]= j;
+    }
+}
 
 /** 
  * @retval NULL `net` is NULL.
  *
  * @details
- * Iterates layer-by-layer to maintain deterministic ordering. Before
- * evaluating a neuron, re-resolves any `'I'`-typed element nested inside
- * its selected `'M'` buffer against the network's current `net_s::in` --
- * every other wiring reference was already resolved once, permanently, by
- * `buildnet()`. All other buffer entries are read as-is via their existing
- * pointer connections.
+ * Iterates layer-by-layer to maintain deterministic ordering. All buffer
+ * entries are read as-is via their existing pointer connections, except
+ * for `'I'` elements nested in `'M'` buffers, which are refreshed from
+ * `net_s::in` (see forwardlayer()).
  */
 data_t **feedforward( net_s *net ){
+    return forwardfrom( net , 0 );
+}
+
+/**
+ * @retval NULL `net` is NULL.
+ *
+ * @details
+ * Evaluates layers `layer` onward exactly as feedforward() does; every
+ * earlier neuron's `neuron_s::out` is read as it currently stands.
+ */
+data_t **forwardfrom( net_s *net , layer_t layer ){
     if( !net ) return NULL;
-    for( layer_t i= 0 ; i < net->layers ; i++ ){
-        for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
-            if( i && net->wiring[i - 1].array_type[net->nn[i][j].bff_idx] == 'M' ) for( uint32_t k= 0 ; k < net->nn[i][j].inputs ; k++ ) switch( net->wiring[i-1].src_type[net->nn[i][j].bff_idx][k] ){
-                case 'I':
-                    net->bff[i - 1][net->nn[i][j].bff_idx][k]= net->in[net->wiring[i - 1].src_index[net->nn[i][j].bff_idx][k]];
-                    break;
-            }
-            activate( &net->nn[i][j] );
-        }
-    }
+    for( layer_t i= layer ; i < net->layers ; i++ ) forwardlayer( net , i );
     return net->out;
-}
\ No newline at end of file
+}
+
+/**
+ * @retval 0 `net` is NULL.
+ *
+ * @details
+ * Runs every layer but the last as feedforward() does, then evaluates the
+ * output layer while ranking it in the same sweep: each output is
+ * inserted into a running top-`k` list as soon as it is computed, so no
+ * second pass over the outputs is needed.
+ *
+ * When every output neuron is softmax, ranking uses the pre-activation
+ * values -- softmax is monotonic, so their order is already final before
+ * normalization. In a layer mixing softmax with other functions, the
+ * softmax outputs are only ranked once the layer has been normalized.
+ *
+ * `k` is clamped to the output layer's size. When `index` is NULL or `k`
+ * is 0, only the highest output is located.
+ */
+uint16_t classify( net_s *net , uint16_t k , uint16_t *index ){
+    if( !net ) return 0;
+    const layer_t last= net->layers - 1;
+    const uint16_t outputs= net->neurons[last];
+    neuron_s *layer= net->nn[last];
+    uint16_t best= 0, ranked= 0, *rank= index && k ? index : &best;
+    k= index && k ? ( k < outputs ? k : outputs ) : 1;
+    data_t value[k], max= -INFINITY, v;
+    uint8_t softmax= 0, all_softmax= 1;
+    for( layer_t i= 0 ; i < last ; i++ ) forwardlayer( net , i );
+    for( uint16_t j= 0 ; j < outputs ; j++ ) all_softmax&= layer[j].fn == NTACT_SOFTMAX;
+    const uint8_t packed= gatherinputs( net , last );
+    for( uint16_t j= 0 ; j < outputs ; j++ ){
+        if( !packed ) refreshinputs( net , last , j );
+        if( layer[j].fn == NTACT_SOFTMAX ){
+            softmax= 1;
+            if( ( v= layer[j].out= layerweighing( net , last , j ) ) > max ) max= v;
+            if( !all_softmax ) continue;
+        } else v= layer[j].out= ntact_activation[layer[j].fn][0]( layerweighing( net , last , j ) );
+        rankoutput( value , rank , &ranked , k , v , j );
+    }
+    if( softmax ) softmaxlayer( layer , outputs , max );
+    if( softmax && !all_softmax ) for( uint16_t j= 0 ; j < outputs ; j++ ) if( layer[j].fn == NTACT_SOFTMAX ) rankoutput( value , rank , &ranked , k , layer[j].out , j );
+    return rank[0];
+}
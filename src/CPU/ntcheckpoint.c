@@ -0,0 +1,249 @@
+/**
+ * @file ntcheckpoint.c
+ * @brief Implementation of asynchronous training checkpoints.
+ *
+ * Checkpoints a network periodically while it trains, without stalling
+ * the training loop: between epochs, its biases, activation selectors and
+ * weights are copied into a staging copy of the network, and a background
+ * thread serializes that copy with savenet(), flushes it to stable
+ * storage and atomically renames it over the previous checkpoint. A run
+ * killed at any moment leaves either the previous checkpoint or the new
+ * one on disk -- never a partial file.
+ *
+ * @author Oscar Sotomayor
+ * @date 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ntcheckpoint.h"
+#include "ntfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+#define EXTENSION ".ntic"
+#define STAGING ".tmp"
+
+struct checkpoint_s {
+    trainhook_s     hook;       /**< Hook chained into traindata_t::hook. */
+    traindata_t     *train_data;/**< Dataset whose hook chain holds `hook`. */
+    net_s           *net;       /**< Network being checkpointed. */
+    net_s           shadow;     /**< Staging copy: the network's structure, with its own neurons. */
+    weight_t        *weights;   /**< Staging storage of every weight. */
+    checkpointconfig_s config;  /**< Settings, with `name` copied. */
+    char            *staging;   /**< Base name written before renaming. */
+    char            *path;      /**< Final checkpoint file. */
+    char            *tmp_path;  /**< Staging checkpoint file. */
+    char            *dir;       /**< Directory holding both files. */
+    struct timespec last;       /**< Time of the last snapshot. */
+    pthread_t       thread;     /**< Writer thread. */
+    pthread_mutex_t lock;       /**< Guards `pending`, `busy` and `stop`. */
+    pthread_cond_t  wake;       /**< Signals the writer, or a waiter on `busy`. */
+    uint8_t         pending;    /**< A snapshot is waiting to be written. */
+    uint8_t         busy;       /**< The staging copy is taken. */
+    uint8_t         stop;       /**< The writer must exit. */
+    size_t          written;    /**< Checkpoints written successfully. */
+};
+
+/**
+ * @details
+ * Seconds elapsed from `from` to `to`.
+ */
+static double elapsed( const struct timespec *from , const struct timespec *to ){
+    return (double)( to->tv_sec - from->tv_sec ) + (double)( to->tv_nsec - from->tv_nsec ) * 1e-9;
+}
+
+/**
+ * @details
+ * Opens `path` and flushes it to stable storage.
+ */
+static int syncpath( const char *path ){
+    int fd= open( path , O_RDONLY );
+    if( fd < 0 ) return -1;
+    int err= fsync( fd );
+    close( fd );
+    return err;
+}
+
+/**
+ * @details
+ * Writer thread: waits for a pending snapshot, writes it to the staging
+ * file, flushes it, renames it over the checkpoint and flushes the
+ * directory entry, then frees the staging copy for the next snapshot.
+ */
+static void *writer( void *arg ){
+    checkpoint_s *c= arg;
+    pthread_mutex_lock( &c->lock );
+    for( ;; ){
+        while( !c->pending && !c->stop ) pthread_cond_wait( &c->wake , &c->lock );
+        if( !c->pending ) break;
+        c->pending= 0;
+        pthread_mutex_unlock( &c->lock );
+        const int ok= savenet( &c->shadow , c->staging ) && !syncpath( c->tmp_path ) && !rename( c->tmp_path , c->path );
+        if( ok ) syncpath( c->dir );
+        pthread_mutex_lock( &c->lock );
+        c->written+= ok;
+        c->busy= 0;
+        pthread_cond_broadcast( &c->wake );
+    }
+    pthread_mutex_unlock( &c->lock );
+    return NULL;
+}
+
+/**
+ * @details
+ * Copies every bias, activation selector and weight of the network into
+ * the staging copy, unless the previous snapshot is still being written
+ * -- the training loop never waits for the disk.
+ */
+int checkpointnow( checkpoint_s *c ){
+    pthread_mutex_lock( &c->lock );
+    const uint8_t busy= c->busy;
+    c->busy= 1;
+    pthread_mutex_unlock( &c->lock );
+    if( busy ) return 0;
+    for( layer_t i= 0 ; i < c->net->layers ; i++ ) for( uint16_t j= 0 ; j < c->net->neurons[i] ; j++ ){
+        c->shadow.nn[i][j].b= c->net->nn[i][j].b;
+        c->shadow.nn[i][j].fn= c->net->nn[i][j].fn;
+        memcpy( c->shadow.nn[i][j].w , c->net->nn[i][j].w , c->net->nn[i][j].inputs * sizeof( weight_t ) );
+    }
+    clock_gettime( CLOCK_MONOTONIC , &c->last );
+    pthread_mutex_lock( &c->lock );
+    c->pending= 1;
+    pthread_cond_broadcast( &c->wake );
+    pthread_mutex_unlock( &c->lock );
+    return 1;
+}
+
+/**
+ * @details
+ * Training hook: snapshots the network when the configured number of
+ * epochs or seconds has passed.
+ */
+static void checkpointhook( net_s *net , const trainstats_s *stats , void *ctx ){
+    checkpoint_s *c= ctx;
+    struct timespec now;
+    (void)net;
+    uint8_t due= c->config.epochs && !( stats->epoch % c->config.epochs );
+    if( !due && c->config.seconds > 0 ){
+        clock_gettime( CLOCK_MONOTONIC , &now );
+        due= elapsed( &c->last , &now ) >= c->config.seconds;
+    }
+    if( due ) checkpointnow( c );
+}
+
+/**
+ * @details
+ * Allocates `a` followed by `b`. The caller frees it.
+ */
+static char *concat( const char *a , const char *b ){
+    char *s= malloc( strlen( a ) + strlen( b ) + 1 );
+    if( s ) strcat( strcpy( s , a ) , b );
+    return s;
+}
+
+/**
+ * @details
+ * Releases everything newcheckpoint() may have allocated.
+ */
+static void release( checkpoint_s *c ){
+    if( c->shadow.nn ) for( layer_t i= 0 ; i < c->net->layers ; i++ ) free( c->shadow.nn[i] );
+    free( c->shadow.nn );
+    free( c->weights );
+    free( (char *)c->config.name );
+    free( c->staging );
+    free( c->path );
+    free( c->tmp_path );
+    free( c->dir );
+    free( c );
+}
+
+/**
+ * @retval NULL
+ *  - `config` or its `name` is NULL.
+ *  - the staging copy or the writer thread could not be created.
+ *
+ * @details
+ * Builds the staging copy once: a shallow copy of `net` sharing its
+ * neuron counts and wiring -- savenet() reads nothing else from them --
+ * with its own neuron arrays, whose weights point into a single staging
+ * block. The checkpointer's hook is then chained first into
+ * traindata_t::hook.
+ */
+checkpoint_s *newcheckpoint( net_s *net , traindata_t *train_data , const checkpointconfig_s *config ){
+    if( !config || !config->name ) return NULL;
+    checkpoint_s *c= calloc( 1 , sizeof( checkpoint_s ) );
+    if( !c ) return c;
+    c->net= net;
+    c->train_data= train_data;
+    c->config= *config;
+    c->config.name= concat( config->name , "" );
+    c->staging= concat( config->name , STAGING );
+    c->path= concat( config->name , EXTENSION );
+    c->tmp_path= concat( config->name , STAGING EXTENSION );
+    c->dir= concat( strchr( config->name , '/' ) ? config->name : "./" , "" );
+    if( c->dir ) strrchr( c->dir , '/' )[ strrchr( c->dir , '/' ) == c->dir ]= '\0';
+    size_t weights= 0;
+    for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) weights+= net->nn[i][j].inputs;
+    c->shadow= *net;
+    c->shadow.layer= NULL;
+    c->shadow.nn= calloc( net->layers , sizeof( neuron_s * ) );
+    c->weights= malloc( weights * sizeof( weight_t ) + 1 );
+    if( !c->config.name || !c->staging || !c->path || !c->tmp_path || !c->dir || !c->shadow.nn || !c->weights ){
+        release( c );
+        return NULL;
+    }
+    weights= 0;
+    for( layer_t i= 0 ; i < net->layers ; i++ ){
+        if( !( c->shadow.nn[i]= calloc( net->neurons[i] , sizeof( neuron_s ) ) ) ){
+            release( c );
+            return NULL;
+        }
+        for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
+            c->shadow.nn[i][j]= net->nn[i][j];
+            c->shadow.nn[i][j].w= c->weights + weights;
+            weights+= net->nn[i][j].inputs;
+        }
+    }
+    clock_gettime( CLOCK_MONOTONIC , &c->last );
+    pthread_mutex_init( &c->lock , NULL );
+    pthread_cond_init( &c->wake , NULL );
+    if( pthread_create( &c->thread , NULL , writer , c ) ){
+        pthread_cond_destroy( &c->wake );
+        pthread_mutex_destroy( &c->lock );
+        release( c );
+        return NULL;
+    }
+    c->hook= (trainhook_s){ .epoch= checkpointhook , .ctx= c , .next= train_data->hook };
+    train_data->hook= &c->hook;
+    return c;
+}
+
+/**
+ * @details
+ * Unlinks the hook wherever it sits in the chain, lets the writer finish
+ * a pending snapshot, then stops it and releases the staging copy.
+ */
+size_t freecheckpoint( checkpoint_s *c ){
+    if( !c ) return 0;
+    for( trainhook_s **hook= &c->train_data->hook ; *hook ; hook= &(*hook)->next ) if( *hook == &c->hook ){
+        *hook= c->hook.next;
+        break;
+    }
+    pthread_mutex_lock( &c->lock );
+    while( c->busy ) pthread_cond_wait( &c->wake , &c->lock );
+    c->stop= 1;
+    pthread_cond_broadcast( &c->wake );
+    pthread_mutex_unlock( &c->lock );
+    pthread_join( c->thread , NULL );
+    pthread_cond_destroy( &c->wake );
+    pthread_mutex_destroy( &c->lock );
+    const size_t written= c->written;
+    release( c );
+    return written;
+}
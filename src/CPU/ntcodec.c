@@ -0,0 +1,202 @@
+/**
+ * @file ntcodec.c
+ * @brief Implementation of a small, dependency-free block compressor.
+ *
+ * A byte-oriented LZ77 codec in the style of LZ4, used to shrink stored
+ * networks. A block is a sequence of tokens; each token's high nibble
+ * holds the length of a literal run, its low nibble the length of the
+ * match that follows, less @ref PACK_MIN_MATCH. A nibble of 15 is
+ * extended by bytes of 255 and a final byte below 255. Literals follow
+ * the token, then the match's 16-bit little-endian distance back into
+ * the output. The last token of a block carries literals only.
+ *
+ * Decompression is a single pass of copies with no tables and no
+ * per-bit work. Compression is a greedy search through a hash table of
+ * 4-byte prefixes, which skips ahead faster while nothing matches, so
+ * incompressible data costs little.
+ *
+ * @author Oscar Sotomayor
+ * @date 2026
+ */
+
+#include "ntcodec.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Shortest match worth a token. */
+#define PACK_MIN_MATCH 4
+
+/** Farthest distance a match can reach back. */
+#define PACK_WINDOW 65535
+
+/** log2 of the number of hash table slots. */
+#define PACK_HASH_BITS 16
+
+/** Misses after which the search starts skipping bytes; as a power of two. */
+#define PACK_SKIP_SHIFT 5
+
+/**
+ * @details
+ * Hash of the 4 bytes at `p`, by Knuth's multiplicative method.
+ */
+static size_t hash4( const unsigned char *p ){
+    uint32_t v;
+    memcpy( &v , p , sizeof( v ) );
+    return (size_t)( ( v * 2654435761u ) >> ( 32 - PACK_HASH_BITS ) );
+}
+
+/**
+ * @details
+ * Appends the extension bytes of a nibble that overflowed: `length`
+ * less 15, as bytes of 255 and a last byte below 255. Returns the new
+ * end of the output, or NULL if it would pass `limit`.
+ */
+static unsigned char *putlength( unsigned char *out , unsigned char *limit , size_t length ){
+    for( ; length >= 255 ; length-= 255 ){
+        if( out == limit ) return NULL;
+        *out++= 255;
+    }
+    if( out == limit ) return NULL;
+    *out++= (unsigned char)length;
+    return out;
+}
+
+/**
+ * @details
+ * Appends one token: `literals` bytes from `from`, then, when `match`
+ * is nonzero, a match of that length at distance `offset`. Returns the
+ * new end of the output, or NULL if it would pass `limit`.
+ */
+static unsigned char *puttoken( unsigned char *out , unsigned char *limit , const unsigned char *from , size_t literals , size_t offset , size_t match ){
+    if( out == limit ) return NULL;
+    unsigned char *token= out++;
+    *token= (unsigned char)( ( literals < 15 ? literals : 15 ) << 4 );
+    if( literals >= 15 && !( out= putlength( out , limit , literals - 15 ) ) ) return NULL;
+    if( literals > (size_t)( limit - out ) ) return NULL;
+    memcpy( out , from , literals );
+    out+= literals;
+    if( !match ) return out;
+    if( limit - out < 2 ) return NULL;
+    *out++= (unsigned char)( offset & 0xFF );
+    *out++= (unsigned char)( offset >> 8 );
+    match-= PACK_MIN_MATCH;
+    *token|= (unsigned char)( match < 15 ? match : 15 );
+    return match >= 15 ? putlength( out , limit , match - 15 ) : out;
+}
+
+/**
+ * @details
+ * Reads the extension bytes of a nibble of 15 into `*length`. Returns
+ * the new read position, or NULL if the input ends first.
+ */
+static const unsigned char *getlength( const unsigned char *in , const unsigned char *end , size_t *length ){
+    unsigned char b;
+    do{
+        if( in == end ) return NULL;
+        *length+= b= *in++;
+    } while( b == 255 );
+    return in;
+}
+
+/**
+ * @details
+ * Worst case: every byte a literal, plus one extension byte per 255 of
+ * them and the token.
+ */
+size_t ntpackbound( size_t size ){
+    return size + size / 255 + 16;
+}
+
+/**
+ * @details
+ * No input byte yields more than 255 output bytes: an extension byte adds
+ * 255 to a length, a token at most 15 literals, each a byte of its own,
+ * and a match of up to 19 bytes that also takes two bytes of offset.
+ */
+size_t ntunpackbound( size_t size ){
+    return size > SIZE_MAX / 255 ? SIZE_MAX : size * 255;
+}
+
+/**
+ * @retval 0 `dst` is too small for the compressed block, or the hash
+ *           table could not be allocated.
+ *
+ * @details
+ * Walks the input keeping, for every hash of 4 bytes, the last position
+ * it was seen at. A candidate within @ref PACK_WINDOW whose 4 bytes
+ * really match is extended forward as far as it goes and backward over
+ * pending literals, then emitted with the literals before it. The last
+ * @ref PACK_MIN_MATCH bytes are always left as literals.
+ */
+size_t ntpack( const void *src , size_t size , void *dst , size_t capacity ){
+    const unsigned char *const in= src, *const end= in + size;
+    unsigned char *out= dst, *const limit= out + capacity;
+    size_t *table= calloc( (size_t)1 << PACK_HASH_BITS , sizeof( size_t ) );
+    if( !table ) return 0;
+    const unsigned char *anchor= in, *p= in;
+    size_t misses= 0;
+    while( out && size > PACK_MIN_MATCH && p < end - PACK_MIN_MATCH ){
+        const size_t h= hash4( p ), seen= table[h];
+        table[h]= (size_t)( p - in ) + 1;
+        const unsigned char *cand= in + seen - 1;
+        if( !seen || p - cand > PACK_WINDOW || memcmp( cand , p , PACK_MIN_MATCH ) ){
+            p+= 1 + ( misses++ >> PACK_SKIP_SHIFT );
+            continue;
+        }
+        size_t match= PACK_MIN_MATCH;
+        while( p + match < end && cand[match] == p[match] ) match++;
+        while( p > anchor && cand > in && p[-1] == cand[-1] ){
+            p--;
+            cand--;
+            match++;
+        }
+        out= puttoken( out , limit , anchor , (size_t)( p - anchor ) , (size_t)( p - cand ) , match );
+        anchor= p+= match;
+        misses= 0;
+    }
+    free( table );
+    if( out ) out= puttoken( out , limit , anchor , (size_t)( end - anchor ) , 0 , 0 );
+    return out ? (size_t)( out - (unsigned char *)dst ) : 0;
+}
+
+/**
+ * @retval 0
+ *  - a length or distance runs past the end of `src`.
+ *  - a match reaches back before the start of `dst`.
+ *  - the output would exceed `capacity`.
+ *
+ * @details
+ * Replays the tokens in order: literals are copied from the input,
+ * matches from earlier output -- byte by byte when a match overlaps the
+ * bytes it produces, as runs do. Every length is checked against both
+ * buffers before it is used, so a malformed block is rejected, never
+ * overrun.
+ */
+size_t ntunpack( const void *src , size_t size , void *dst , size_t capacity ){
+    const unsigned char *in= src, *const end= in + size;
+    unsigned char *const start= dst, *out= start, *const limit= start + capacity;
+    while( in < end ){
+        const unsigned char token= *in++;
+        size_t literals= token >> 4;
+        if( literals == 15 && !( in= getlength( in , end , &literals ) ) ) return 0;
+        if( literals > (size_t)( end - in ) || literals > (size_t)( limit - out ) ) return 0;
+        memcpy( out , in , literals );
+        out+= literals;
+        in+= literals;
+        if( in == end ) break;
+        if( end - in < 2 ) return 0;
+        const size_t offset= (size_t)in[0] | (size_t)in[1] << 8;
+        in+= 2;
+        size_t match= token & 15;
+        if( match == 15 && !( in= getlength( in , end , &match ) ) ) return 0;
+        match+= PACK_MIN_MATCH;
+        if( !offset || offset > (size_t)( out - start ) || match > (size_t)( limit - out ) ) return 0;
+        const unsigned char *from= out - offset;
+        if( offset >= match ) memcpy( out , from , match );
+        else for( size_t k= 0 ; k < match ; k++ ) out[k]= from[k];
+        out+= match;
+    }
+    return (size_t)( out - start );
+}
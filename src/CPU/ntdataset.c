@@ -0,0 +1,477 @@
+/**
+ * @file ntdataset.c
+ * @brief Implementation of training dataset persistence for NeuroTIC.
+ *
+ * Stores a traindata_t's two row-major matrices in a binary `.ntds` file,
+ * and maps such a file back read-only, so that a dataset of any size can
+ * be used for training without being parsed or copied.
+ *
+ * File layout, every field little-endian:
+ * | Offset | Size | Content |
+ * |---|---|---|
+ * | 0 | 8 | Magic string `NTICDATA`. |
+ * | 8 | 1 | Format version. |
+ * | 12 | 4 | Values per input row (traindata_t::inputs). |
+ * | 16 | 8 | Number of samples. |
+ * | 24 | 4 | Values per expected output row (traindata_t::outputs). |
+ * | 64 | samples x inputs x 4 | Input matrix, IEEE 754 binary32. |
+ * | next multiple of 64 | samples x outputs x 4 | Expected output matrix, IEEE 754 binary32. |
+ *
+ * Every unlisted byte up to offset 64 is zero. Both matrices start on a
+ * 64-byte boundary, so a mapped file can be read in place.
+ *
+ * Also imports delimited text files (CSV/TSV) straight into a dataset's
+ * matrices, parsing them in parallel.
+ *
+ * @author Oscar Sotomayor
+ * @date 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ntdataset.h"
+#include "ntfile.h"
+#include "ntmemory.h"
+#include "ntthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define EXTENSION ".ntds"
+#define MAGIC "NTICDATA"
+#define VERSION 0x0
+#define HEADER_SIZE 64
+#define BLOCK_ALIGN 64
+
+/**
+ * @details
+ * Rounds `size` up to the next multiple of `BLOCK_ALIGN`.
+ */
+static size_t alignblock( size_t size ){
+    return ( size + BLOCK_ALIGN - 1 ) / BLOCK_ALIGN * BLOCK_ALIGN;
+}
+
+/**
+ * @details
+ * Allocates `name` + `EXTENSION`. The caller frees it.
+ */
+static char *filename( const char *name ){
+    char *path= malloc( strlen( name ) + sizeof( EXTENSION ) );
+    if( path ) strcat( strcpy( path , name ) , EXTENSION );
+    return path;
+}
+
+/**
+ * @details
+ * Writes `count` values from `values` as little-endian IEEE 754 binary32.
+ * On a host already using that representation, the values are written as
+ * they are, in one call; otherwise they are converted through a small
+ * stack buffer.
+ */
+static size_t writevalues( const data_t *values , size_t count , uint8_t native , uint8_t little_endian , uint8_t ieee754 , FILE *fp ){
+    if( native ) return fwrite( values , sizeof( data_t ) , count , fp );
+    uint32_t buffer[256];
+    size_t written= 0;
+    for( size_t i= 0 ; i < count ; i+= 256 ){
+        size_t n= count - i < 256 ? count - i : 256;
+        for( size_t j= 0 ; j < n ; j++ ){
+            buffer[j]= float32( values[i + j] , ieee754 );
+            if( !little_endian ) buffer[j]= bswap32( buffer[j] );
+        }
+        written+= fwrite( buffer , sizeof( uint32_t ) , n , fp );
+    }
+    return written;
+}
+
+/**
+ * @retval 0
+ *  - traindata_t::inputs or traindata_t::outputs is zero.
+ *  - the file could not be opened for writing, or a write fell short.
+ *
+ * @details
+ * Writes the header, then the input matrix and the expected output
+ * matrix, each padded to a 64-byte boundary. Each matrix is written in a
+ * single call when its rows are contiguous (traindata_t::in_block /
+ * traindata_t::results_block set), or row by row otherwise.
+ */
+size_t savetraindata( traindata_t *train_data , const char *name ){
+    size_t file_size= 0;
+    if( !train_data->inputs || !train_data->outputs ) return file_size;
+    const uint8_t little_endian= checkendian( ) , ieee754= isieee754( ) , native= little_endian && ieee754 && sizeof( data_t ) == 4;
+    char *path= filename( name );
+    FILE *fp= path ? fopen( path , "wb" ) : NULL;
+    free( path );
+    if( !fp ) return file_size;
+    static const uint8_t zero[BLOCK_ALIGN];
+    uint8_t header[HEADER_SIZE]= { 0 };
+    const uint64_t samples= train_data->samples;
+    memcpy( header , MAGIC , sizeof( MAGIC ) - 1 );
+    header[8]= VERSION;
+    for( uint8_t i= 0 ; i < 4 ; i++ ) header[12 + i]= (uint8_t)( train_data->inputs >> ( 8 * i ) );
+    for( uint8_t i= 0 ; i < 8 ; i++ ) header[16 + i]= (uint8_t)( samples >> ( 8 * i ) );
+    for( uint8_t i= 0 ; i < 4 ; i++ ) header[24 + i]= (uint8_t)( (uint32_t)train_data->outputs >> ( 8 * i ) );
+    uint8_t failed= fwrite( header , 1 , HEADER_SIZE , fp ) != HEADER_SIZE;
+    const size_t padding[2]= {
+        alignblock( train_data->samples * train_data->inputs * sizeof( uint32_t ) ) - train_data->samples * train_data->inputs * sizeof( uint32_t ),
+        alignblock( train_data->samples * train_data->outputs * sizeof( uint32_t ) ) - train_data->samples * train_data->outputs * sizeof( uint32_t )
+    };
+    data_t **rows[2]= { train_data->in , train_data->results } , *blocks[2]= { train_data->in_block , train_data->results_block };
+    const size_t width[2]= { train_data->inputs , train_data->outputs };
+    for( uint8_t m= 0 ; m < 2 && !failed ; m++ ){
+        if( blocks[m] ) failed|= writevalues( blocks[m] , train_data->samples * width[m] , native , little_endian , ieee754 , fp ) != train_data->samples * width[m];
+        else for( sample_t i= 0 ; i < train_data->samples && !failed ; i++ ) failed|= writevalues( rows[m][i] , width[m] , native , little_endian , ieee754 , fp ) != width[m];
+        if( padding[m] ) failed|= fwrite( zero , 1 , padding[m] , fp ) != padding[m];
+    }
+    if( !failed ){
+        fseek( fp , 0 , SEEK_END );
+        file_size= ftell( fp );
+    }
+    fclose( fp );
+    return file_size;
+}
+
+/**
+ * @retval 1 the filename could not be allocated.
+ * @retval 2 the file could not be opened or mapped.
+ * @retval 3 the file's magic string or version byte does not match what
+ *           this module writes, its header declares matrices too large
+ *           to address, or the file is shorter than its header declares.
+ * @retval 4 the row pointer arrays (or, on a host not using little-endian
+ *           IEEE 754 floats, the converted matrices) could not be
+ *           allocated.
+ *
+ * @details
+ * Maps the whole file read-only. On a little-endian IEEE 754 host,
+ * traindata_t::in_block and traindata_t::results_block point straight
+ * into the mapping, and only the two row pointer arrays are allocated --
+ * no matrix value is read or copied until training touches it. The
+ * mapping is advised for sequential access, matching the order in which
+ * backpropagation() visits samples.
+ *
+ * On any other host, both matrices are converted into freshly allocated
+ * blocks and the mapping is released immediately.
+ *
+ * Whatever traindata_t held before is overwritten, not released.
+ *
+ * @warning
+ * A mapped dataset is read-only: writing through traindata_t::in or
+ * traindata_t::results raises a segmentation fault.
+ */
+size_t maptraindata( traindata_t *train_data , const char *name ){
+    size_t err_val= 0;
+    const uint8_t little_endian= checkendian( ) , ieee754= isieee754( ) , native= little_endian && ieee754 && sizeof( data_t ) == 4;
+    struct stat st;
+    uint8_t *map= MAP_FAILED;
+    char *path= filename( name );
+    if( !path ) return 1;
+    int fd= open( path , O_RDONLY );
+    free( path );
+    if( fd < 0 ) return 2;
+    if( fstat( fd , &st ) || (size_t)st.st_size < HEADER_SIZE || ( map= mmap( NULL , (size_t)st.st_size , PROT_READ , MAP_PRIVATE , fd , 0 ) ) == MAP_FAILED ){
+        close( fd );
+        return 2;
+    }
+    close( fd );
+    uint32_t inputs= 0, outputs= 0;
+    uint64_t samples= 0;
+    for( uint8_t i= 0 ; i < 4 ; i++ ) inputs|= (uint32_t)map[12 + i] << ( 8 * i );
+    for( uint8_t i= 0 ; i < 8 ; i++ ) samples|= (uint64_t)map[16 + i] << ( 8 * i );
+    for( uint8_t i= 0 ; i < 4 ; i++ ) outputs|= (uint32_t)map[24 + i] << ( 8 * i );
+    const uint64_t width= (uint64_t)inputs + outputs;
+    const uint8_t fits= !width || samples <= ( SIZE_MAX - HEADER_SIZE - BLOCK_ALIGN ) / sizeof( uint32_t ) / width;
+    const size_t in_size= fits ? alignblock( samples * inputs * sizeof( uint32_t ) ) : 0 , results_size= fits ? samples * outputs * sizeof( uint32_t ) : 0;
+    if( memcmp( map , MAGIC , sizeof( MAGIC ) - 1 ) || map[8] != VERSION || outputs > UINT16_MAX || !fits || (size_t)st.st_size < HEADER_SIZE + in_size + results_size ){
+        munmap( map , (size_t)st.st_size );
+        return 3;
+    }
+    train_data->samples= samples;
+    train_data->inputs= inputs;
+    train_data->outputs= (uint16_t)outputs;
+    train_data->map= NULL;
+    train_data->map_size= 0;
+    train_data->in= createblock( train_data , calloc( samples + !samples , sizeof( data_t * ) ) , ( samples + !samples ) * sizeof( data_t * ) );
+    train_data->results= createblock( train_data , calloc( samples + !samples , sizeof( data_t * ) ) , ( samples + !samples ) * sizeof( data_t * ) );
+    if( native ){
+        train_data->in_block= (data_t *)( map + HEADER_SIZE );
+        train_data->results_block= (data_t *)( map + HEADER_SIZE + in_size );
+        train_data->map= map;
+        train_data->map_size= (size_t)st.st_size;
+        posix_madvise( map , (size_t)st.st_size , POSIX_MADV_SEQUENTIAL );
+    } else {
+        train_data->in_block= createblock( train_data , calloc( samples * inputs + 1 , sizeof( data_t ) ) , ( samples * inputs + 1 ) * sizeof( data_t ) );
+        train_data->results_block= createblock( train_data , calloc( samples * outputs + 1 , sizeof( data_t ) ) , ( samples * outputs + 1 ) * sizeof( data_t ) );
+        if( train_data->in_block && train_data->results_block ){
+            const uint8_t *src;
+            data_t *blocks[2]= { train_data->in_block , train_data->results_block };
+            const size_t count[2]= { samples * inputs , samples * outputs } , offset[2]= { HEADER_SIZE , HEADER_SIZE + in_size };
+            for( uint8_t m= 0 ; m < 2 ; m++ ) for( size_t i= 0 ; i < count[m] ; i++ ){
+                src= map + offset[m] + i * sizeof( uint32_t );
+                blocks[m][i]= floatsys( (int32_t)( (uint32_t)src[0] | (uint32_t)src[1] << 8 | (uint32_t)src[2] << 16 | (uint32_t)src[3] << 24 ) , ieee754 );
+            }
+        }
+        munmap( map , (size_t)st.st_size );
+    }
+    if( !( train_data->in && train_data->results && train_data->in_block && train_data->results_block ) ){
+        err_val= 4;
+        unmaptraindata( train_data );
+        return err_val;
+    }
+    for( sample_t i= 0 ; i < samples ; i++ ){
+        train_data->in[i]= train_data->in_block + i * inputs;
+        train_data->results[i]= train_data->results_block + i * outputs;
+    }
+    return err_val;
+}
+
+/**
+ * @details
+ * Shared state of one importcsv() call, read by every parser thread.
+ * Chunk `c` spans bytes `bound[c]` up to `bound[c + 1]` of `text`, always
+ * starting at the beginning of a line, and its rows are written from
+ * sample `first[c]` onward.
+ */
+struct csvjob_s {
+    const char      *text;          /**< File contents after the skipped lines. */
+    size_t          *bound;         /**< Chunk boundaries, size chunks + 1. */
+    sample_t        *first;         /**< First sample of each chunk, size chunks + 1. */
+    traindata_t     *train_data;    /**< Dataset being filled. */
+    const csvformat_s *format;      /**< Column selection. */
+    char            delimiter;      /**< Resolved field separator. */
+    uint32_t        columns;        /**< Fields parsed per line: highest selected column + 1. */
+    data_t          *fields;        /**< Parsed fields, `columns` per chunk. */
+};
+
+/**
+ * @details
+ * Exact powers of ten representable as a double.
+ */
+static const double exact_pow10[]= {
+    1e0 , 1e1 , 1e2 , 1e3 , 1e4 , 1e5 , 1e6 , 1e7 , 1e8 , 1e9 , 1e10 , 1e11 ,
+    1e12 , 1e13 , 1e14 , 1e15 , 1e16 , 1e17 , 1e18 , 1e19 , 1e20 , 1e21 , 1e22
+};
+
+/**
+ * @details
+ * Reports whether the line spanning `p` up to `end` holds anything other
+ * than spaces, tabs and carriage returns. Blank lines are never turned
+ * into samples.
+ */
+static int filledline( const char *p , const char *end ){
+    for( ; p < end ; p++ ) if( *p != ' ' && *p != '\t' && *p != '\r' ) return 1;
+    return 0;
+}
+
+/**
+ * @details
+ * Parses one decimal number starting at `p`, not reading at or past
+ * `end`, and returns a pointer to the first character after it. Leading
+ * blanks and a surrounding pair of double quotes are skipped.
+ *
+ * Up to 19 significant digits are accumulated into an integer and scaled
+ * once by an exact power of ten, which covers the plain and scientific
+ * notations written by common tools without calling into the C library.
+ * Anything else (exponents beyond +-22 after scaling, `inf`, `nan`) is
+ * handed to strtod() on a bounded copy of the token. A field holding no
+ * number at all reads as 0.
+ */
+static const char *parsefloat( const char *p , const char *end , char delimiter , data_t *value ){
+    const char *token;
+    uint64_t mantissa= 0;
+    int32_t exponent= 0, digits= 0;
+    uint8_t negative= 0, any= 0;
+    while( p < end && ( *p == ' ' || *p == '"' || ( *p == '\t' && delimiter != '\t' ) ) ) p++;
+    token= p;
+    if( p < end && ( *p == '-' || *p == '+' ) ) negative= *p++ == '-';
+    for( ; p < end && (unsigned)( *p - '0' ) < 10 ; p++ , any= 1 ) if( digits < 19 ){
+        mantissa= mantissa * 10 + (unsigned)( *p - '0' );
+        digits+= digits || *p != '0';
+    } else exponent++;
+    if( p < end && *p == '.' ) for( p++ ; p < end && (unsigned)( *p - '0' ) < 10 ; p++ , any= 1 ) if( digits < 19 ){
+        mantissa= mantissa * 10 + (unsigned)( *p - '0' );
+        digits+= digits || *p != '0';
+        exponent--;
+    }
+    if( any && p < end && ( *p == 'e' || *p == 'E' ) ){
+        const char *mark= p++;
+        int32_t sign= 1, e= 0;
+        if( p < end && ( *p == '-' || *p == '+' ) ) sign= *p++ == '-' ? -1 : 1;
+        if( p < end && (unsigned)( *p - '0' ) < 10 ) for( ; p < end && (unsigned)( *p - '0' ) < 10 ; p++ ) e= e < 100000 ? e * 10 + ( *p - '0' ) : e;
+        else p= mark;
+        exponent+= sign * e;
+    }
+    if( any && exponent >= -22 && exponent <= 22 ){
+        double v= (double)mantissa;
+        v= exponent < 0 ? v / exact_pow10[-exponent] : v * exact_pow10[exponent];
+        *value= (data_t)( negative ? -v : v );
+    } else if( any || ( p < end && *p != delimiter && *p != '\r' ) ){
+        char buffer[64];
+        size_t n= 0;
+        for( p= token ; p < end && *p != delimiter && *p != '"' && *p != '\r' && n < sizeof( buffer ) - 1 ; p++ ) buffer[n++]= *p;
+        buffer[n]= '\0';
+        *value= (data_t)strtod( buffer , NULL );
+    } else *value= 0.0f;
+    while( p < end && *p == '"' ) p++;
+    return p;
+}
+
+/**
+ * @details
+ * ntparallel() callback counting the non-blank lines of chunks `begin` up
+ * to `end`, storing each chunk's count in `first[chunk + 1]`.
+ */
+static void countlines( void *ctx , size_t begin , size_t end , unsigned worker ){
+    struct csvjob_s *job= ctx;
+    (void)worker;
+    for( size_t c= begin ; c < end ; c++ ){
+        sample_t count= 0;
+        for( const char *p= job->text + job->bound[c] , *stop= job->text + job->bound[c + 1] , *eol ; p < stop ; p= eol + 1 ){
+            if( !( eol= memchr( p , '\n' , (size_t)( stop - p ) ) ) ) eol= stop;
+            count+= filledline( p , eol );
+        }
+        job->first[c + 1]= count;
+    }
+}
+
+/**
+ * @details
+ * ntparallel() callback parsing chunks `begin` up to `end`. Each
+ * non-blank line is split into its first `columns` fields, which are then
+ * scattered into the line's input and expected output rows.
+ */
+static void parselines( void *ctx , size_t begin , size_t end , unsigned worker ){
+    struct csvjob_s *job= ctx;
+    traindata_t *train_data= job->train_data;
+    const csvformat_s *format= job->format;
+    (void)worker;
+    for( size_t c= begin ; c < end ; c++ ){
+        data_t *fields= job->fields + c * job->columns;
+        sample_t sample= job->first[c];
+        for( const char *p= job->text + job->bound[c] , *stop= job->text + job->bound[c + 1] , *eol ; p < stop ; p= eol + 1 ){
+            if( !( eol= memchr( p , '\n' , (size_t)( stop - p ) ) ) ) eol= stop;
+            if( !filledline( p , eol ) ) continue;
+            for( uint32_t f= 0 ; f < job->columns ; f++ ){
+                if( p < eol ) p= parsefloat( p , eol , job->delimiter , &fields[f] );
+                else fields[f]= 0.0f;
+                while( p < eol && *p != job->delimiter ) p++;
+                p+= p < eol;
+            }
+            data_t *in= train_data->in[sample], *results= train_data->results[sample];
+            for( input_t i= 0 ; i < train_data->inputs ; i++ ) in[i]= fields[format && format->in_columns ? format->in_columns[i] : i];
+            if( format && format->labeled ){
+                const data_t label= fields[format->label_column];
+                if( label >= 0.0f && label < (data_t)train_data->outputs ) results[(uint16_t)label]= 1.0f;
+            } else for( uint16_t i= 0 ; i < train_data->outputs ; i++ ) results[i]= fields[format && format->result_columns ? format->result_columns[i] : train_data->inputs + i];
+            sample++;
+        }
+    }
+}
+
+/**
+ * @retval 1 the file could not be opened or mapped.
+ * @retval 2 the dataset or the parser's scratch memory could not be
+ *           allocated.
+ *
+ * @details
+ * Maps the file read-only and parses it in two parallel passes over the
+ * same chunks, each cut at a line boundary:
+ * - the first counts the non-blank lines of every chunk, which fixes the
+ *   sample count and where each chunk's rows start;
+ * - after newtraindata() allocates the dataset, the second parses every
+ *   chunk straight into its rows -- no intermediate copy of the text or of
+ *   the values is made.
+ *
+ * Every line, after the first `csvformat_s::skip`, is one sample. A line
+ * with fewer fields than selected leaves the missing values at 0, and a
+ * one-hot label outside `0 .. outputs - 1` leaves its row all zeros.
+ * Whatever traindata_t held before is overwritten, not released.
+ */
+size_t importcsv( traindata_t *train_data , net_s *net , const char *path , const csvformat_s *format ){
+    size_t err_val= 0;
+    struct stat st;
+    char *map= NULL;
+    int fd= open( path , O_RDONLY );
+    if( fd < 0 ) return 1;
+    if( fstat( fd , &st ) ){
+        close( fd );
+        return 1;
+    }
+    const size_t size= (size_t)st.st_size;
+    if( size && ( map= mmap( NULL , size , PROT_READ , MAP_PRIVATE , fd , 0 ) ) == MAP_FAILED ){
+        close( fd );
+        return 1;
+    }
+    close( fd );
+    if( map ) posix_madvise( map , size , POSIX_MADV_SEQUENTIAL );
+    struct csvjob_s job= { .text= map , .train_data= train_data , .format= format , .delimiter= format ? format->delimiter : 0 };
+    size_t offset= 0;
+    for( uint32_t i= 0 ; format && i < format->skip && offset < size ; i++ ){
+        const char *eol= memchr( map + offset , '\n' , size - offset );
+        offset= eol ? (size_t)( eol - map ) + 1 : size;
+    }
+    job.text= map ? map + offset : map;
+    const size_t body= size - offset;
+    if( !job.delimiter ){
+        const char *eol= body ? memchr( job.text , '\n' , body ) : NULL;
+        const size_t line= eol ? (size_t)( eol - job.text ) : body;
+        job.delimiter= line && memchr( job.text , '\t' , line ) ? '\t' : line && memchr( job.text , ';' , line ) && !memchr( job.text , ',' , line ) ? ';' : ',';
+    }
+    const input_t inputs= net->inputs;
+    const uint16_t outputs= net->neurons[net->layers - 1];
+    job.columns= format && format->labeled ? format->label_column + 1 : inputs + ( format && format->result_columns ? 0 : outputs );
+    for( input_t i= 0 ; i < inputs ; i++ ){
+        const uint32_t column= format && format->in_columns ? format->in_columns[i] : i;
+        if( column >= job.columns ) job.columns= column + 1;
+    }
+    if( format && !format->labeled && format->result_columns ) for( uint16_t i= 0 ; i < outputs ; i++ ) if( format->result_columns[i] >= job.columns ) job.columns= format->result_columns[i] + 1;
+    size_t chunks= format && format->threads ? format->threads : ntthreads( );
+    if( chunks > body / 4096 + 1 ) chunks= body / 4096 + 1;
+    job.bound= malloc( ( chunks + 1 ) * sizeof( size_t ) );
+    job.first= calloc( chunks + 1 , sizeof( sample_t ) );
+    job.fields= malloc( chunks * job.columns * sizeof( data_t ) + 1 );
+    if( !job.bound || !job.first || !job.fields ){
+        err_val= 2;
+        goto EXIT;
+    }
+    job.bound[0]= 0;
+    job.bound[chunks]= body;
+    for( size_t c= 1 ; c < chunks ; c++ ){
+        size_t at= body / chunks * c;
+        const char *eol= at < body ? memchr( job.text + at , '\n' , body - at ) : NULL;
+        at= eol ? (size_t)( eol - job.text ) + 1 : body;
+        job.bound[c]= at > job.bound[c - 1] ? at : job.bound[c - 1];
+    }
+    ntparallel( chunks , (unsigned)chunks , countlines , &job );
+    for( size_t c= 0 ; c < chunks ; c++ ) job.first[c + 1]+= job.first[c];
+    train_data->samples= job.first[chunks];
+    newtraindata( train_data , net );
+    if( !train_data->in ){
+        err_val= 2;
+        goto EXIT;
+    }
+    ntparallel( chunks , (unsigned)chunks , parselines , &job );
+    EXIT:
+    free( job.bound );
+    free( job.first );
+    free( job.fields );
+    if( map ) munmap( map , size );
+    return err_val;
+}
+
+/**
+ * @details
+ * Unmaps traindata_t::map if set, then frees every block registered under
+ * `train_data` and clears its data pointers. Training parameters and
+ * dimensions are left untouched.
+ */
+void unmaptraindata( traindata_t *train_data ){
+    if( train_data->map ) munmap( train_data->map , train_data->map_size );
+    deleteowner( train_data );
+    train_data->map= NULL;
+    train_data->map_size= 0;
+    train_data->in= train_data->results= NULL;
+    train_data->in_block= train_data->results_block= NULL;
+}
@@ -31,6 +31,7 @@ net_s *definestructure( net_s *net ){
     net->wiring= NULL;
     net->bff= NULL;
     net->out= NULL;
+    net->layer= NULL;
     printf( "Network structure\n" );
     printf( "  Inputs: " );
     scanf( " %u" , &net->inputs );
@@ -70,18 +71,18 @@ net_s *definetopology( net_s *net ){
         printf( "\n  Input sets: " );
         scanf( " %hhu" , &net->wiring[L].arrays );
         net->wiring[L].arrays+= !net->wiring[L].arrays;
-        net->wiring[L].array_type= createregister( net , calloc( net->wiring[L].arrays , sizeof( type_t ) ) );
-        net->wiring[L].size= createregister( net , calloc( net->wiring[L].arrays , sizeof( input_t ) ) );
-        net->wiring[L].src_layer= createregister( net , calloc( net->wiring[L].arrays , sizeof( layer_t * ) ) );
-        net->wiring[L].src_index= createregister( net , calloc( net->wiring[L].arrays , sizeof( uint16_t * ) ) );
-        net->wiring[L].src_type= createregister( net , calloc( net->wiring[L].arrays , sizeof( type_t * ) ) );
+        net->wiring[L].array_type= arenaalloc( net , net->wiring[L].arrays * sizeof( type_t ) );
+        net->wiring[L].size= arenaalloc( net , net->wiring[L].arrays * sizeof( input_t ) );
+        net->wiring[L].src_layer= arenaalloc( net , net->wiring[L].arrays * sizeof( layer_t * ) );
+        net->wiring[L].src_index= arenaalloc( net , net->wiring[L].arrays * sizeof( uint16_t * ) );
+        net->wiring[L].src_type= arenaalloc( net , net->wiring[L].arrays * sizeof( type_t * ) );
         for( index_t j= 0 ; j < net->wiring[L].arrays ; j++ ){
             printf( "  [%u] Type (N/I/O/M): " , j );
             scanf( " %c" , (char*)&net->wiring[L].array_type[j] );
             switch( net->wiring[L].array_type[j]) {
                 case 'N':
-                    net->wiring[L].src_layer[j]= createregister( net , calloc( 1 , sizeof( layer_t ) ) );
-                    net->wiring[L].src_index[j]= createregister( net , calloc( 1 , sizeof( uint16_t ) ) );
+                    net->wiring[L].src_layer[j]= arenaalloc( net , sizeof( layer_t ) );
+                    net->wiring[L].src_index[j]= arenaalloc( net , sizeof( uint16_t ) );
                     net->wiring[L].src_type[j]= NULL;
                     printf( "      Source layer: " );
                     scanf( "%hu" , net->wiring[L].src_layer[j] );
@@ -101,9 +102,9 @@ net_s *definetopology( net_s *net ){
                 case 'M':
                     printf( "      BFF size: " );
                     scanf( " %u" , &net->wiring[L].size[j] );
-                    net->wiring[L].src_layer[j]= createregister( net , calloc( net->wiring[L].size[j] , sizeof( layer_t ) ) );
-                    net->wiring[L].src_index[j]= createregister( net , calloc( net->wiring[L].size[j] , sizeof( uint16_t ) ) );
-                    net->wiring[L].src_type[j]= createregister( net , calloc( net->wiring[L].size[j] , sizeof( type_t ) ) );
+                    net->wiring[L].src_layer[j]= arenaalloc( net , net->wiring[L].size[j] * sizeof( layer_t ) );
+                    net->wiring[L].src_index[j]= arenaalloc( net , net->wiring[L].size[j] * sizeof( uint16_t ) );
+                    net->wiring[L].src_type[j]= arenaalloc( net , net->wiring[L].size[j] * sizeof( type_t ) );
                     for( uint16_t k= 0 ; k < net->wiring[L].size[j] ; k++ ){
                         printf( "      [%u] Source type (N/I/O): " , k );
                         scanf( " %c" , &net->wiring[L].src_type[j][k] );
@@ -0,0 +1,264 @@
+/**
+ * @file ntevolve.c
+ * @brief Implementation of gradient-free training by evolution strategies.
+ *
+ * Trains networks whose activations have no usable derivative -- e.g.
+ * boolean step networks -- by sampling many random perturbations of their
+ * parameters per generation, scoring every one on the training set in
+ * parallel, and moving toward the best. Perturbations are never stored:
+ * each is regenerated on demand from a counter-based generator keyed by
+ * the seed, the generation and the candidate, so candidates cost no
+ * weight copies. The best parameter sets found so far form an elite that
+ * survives across generations.
+ *
+ * @author Oscar Sotomayor
+ * @date 2026
+ */
+
+#include "ntevolve.h"
+
+#include "ntbuilder.h"
+#include "ntcalculate.h"
+#include "ntmemory.h"
+#include "ntrandom.h"
+#include "ntthread.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DEFAULT_POPULATION 64
+#define DEFAULT_SIGMA 0.1f
+
+/**
+ * @details
+ * State shared by every worker of one evolvenet() call.
+ */
+typedef struct evolvejob_s {
+    net_s           *net;
+    const traindata_t *data;
+    net_s           *replicas;      /**< One network per worker, same structure as `net`. */
+    data_t          **inputs;       /**< Input buffer bound to each replica. */
+    const float     *center;        /**< Current parameter vector. */
+    size_t          params;         /**< Number of weights and biases. */
+    float           sigma;
+    uint64_t        seed;
+    uint64_t        generation;
+    precision_t     *error;         /**< Error of each candidate. */
+} evolvejob_s;
+
+/**
+ * @details
+ * Standard normal value number `p` of the perturbation keyed `key`: the
+ * key and index are hashed into 64 random bits, whose halves feed a
+ * Box-Muller transform. Any value can be recomputed in isolation.
+ */
+static float noise( uint64_t key , uint64_t p ){
+    const uint64_t h= ntmix( key ^ ( p * 0x9E3779B97F4A7C15ull ) );
+    const float u= ( (float)( h >> 40 ) + 1.0f ) * ( 1.0f / 16777216.0f ), v= (float)( ( h >> 16 ) & 0xFFFFFF ) * ( 1.0f / 16777216.0f );
+    return sqrtf( -2.0f * logf( u ) ) * cosf( 6.28318530718f * v );
+}
+
+/**
+ * @details
+ * Key of candidate `candidate` of generation `generation`. Candidates
+ * come in antithetic pairs sharing one key: the even one adds the
+ * perturbation, the odd one subtracts it.
+ */
+static uint64_t candidatekey( uint64_t seed , uint64_t generation , uint32_t candidate ){
+    return ntmix( seed ^ ntmix( ( generation << 32 ) | ( candidate >> 1 ) ) );
+}
+
+/**
+ * @details
+ * Writes candidate `candidate`'s parameters -- the center plus its signed,
+ * scaled perturbation -- into `net`, or into `params` when it is non-NULL.
+ * Parameters are laid out neuron by neuron, weights then bias.
+ */
+static void writecandidate( const evolvejob_s *job , uint32_t candidate , net_s *net , float *params ){
+    const uint64_t key= candidatekey( job->seed , job->generation , candidate );
+    const float scale= candidate & 1 ? -job->sigma : job->sigma;
+    size_t p= 0;
+    for( layer_t i= 0 ; i < job->net->layers ; i++ ) for( uint16_t j= 0 ; j < job->net->neurons[i] ; j++ ){
+        const input_t inputs= job->net->nn[i][j].inputs;
+        for( input_t k= 0 ; k <= inputs ; k++ , p++ ){
+            const float value= job->center[p] + scale * noise( key , p );
+            if( params ) params[p]= value;
+            else if( k < inputs ) net->nn[i][j].w[k]= value;
+            else net->nn[i][j].b= value;
+        }
+    }
+}
+
+/**
+ * @details
+ * Copies a parameter vector into `net`.
+ */
+static void setparams( net_s *net , const float *params ){
+    size_t p= 0;
+    for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
+        for( input_t k= 0 ; k < net->nn[i][j].inputs ; k++ ) net->nn[i][j].w[k]= params[p++];
+        net->nn[i][j].b= params[p++];
+    }
+}
+
+/**
+ * @details
+ * Cumulative absolute output error of `net` over the training set, with
+ * its inputs bound to `in` -- the same measure backpropagation() compares
+ * against traindata_t::tolerance.
+ */
+static precision_t fitness( net_s *net , data_t *in , const traindata_t *data ){
+    const uint16_t outputs= net->neurons[net->layers - 1];
+    precision_t error= 0;
+    for( sample_t s= 0 ; s < data->samples ; s++ ){
+        memcpy( in , data->in[s] , (size_t)net->inputs * sizeof( data_t ) );
+        feedforward( net );
+        for( uint16_t o= 0 ; o < outputs ; o++ ) error+= fabsf( data->results[s][o] - *net->out[o] );
+    }
+    return error;
+}
+
+/**
+ * @details
+ * ntparallel() callback: scores candidates `[begin, end)` on the calling
+ * worker's own replica.
+ */
+static void evaluaterange( void *ctx , size_t begin , size_t end , unsigned worker ){
+    evolvejob_s *job= ctx;
+    for( size_t c= begin ; c < end ; c++ ){
+        writecandidate( job , (uint32_t)c , &job->replicas[worker] , NULL );
+        job->error[c]= fitness( &job->replicas[worker] , job->inputs[worker] , job->data );
+    }
+}
+
+/**
+ * @retval NULL the replica could not be built.
+ *
+ * @details
+ * Builds `replica` as a clonenet() of `net` with weights of its own, so
+ * writing candidates into it never touches `net`. Its inputs are bound
+ * to a buffer it owns, stored into `*in`.
+ */
+static net_s *replicate( net_s *replica , net_s *net , data_t **in ){
+    if( !ownweights( clonenet( replica , net ) ) ) return NULL;
+    if( !( *in= createblock( replica , calloc( (size_t)net->inputs + 1 , sizeof( data_t ) ) , ( (size_t)net->inputs + 1 ) * sizeof( data_t ) ) ) ) return NULL;
+    for( input_t k= 0 ; k < net->inputs ; k++ ) replica->in[k]= &(*in)[k];
+    return replica;
+}
+
+/**
+ * @retval 0 the replicas or scratch could not be allocated, `net`'s
+ *           weights could not be unshared from its clones, or the
+ *           dataset has no in-memory samples -- no training took place.
+ *
+ * @details
+ * A (μ/μ_w, λ) evolution strategy with an elite archive. Each generation:
+ * - Samples `population` candidates around the current center as
+ *   antithetic pairs, center ± σ·ε, with ε regenerated from its
+ *   counter-based key whenever needed.
+ * - Scores every candidate in parallel, one network replica per thread,
+ *   by its cumulative absolute error over the training set.
+ * - Ranks the candidates together with the elite archive and moves the
+ *   center to the weighted mean of the best `population / 2` of them,
+ *   weights decreasing logarithmically with rank -- only ranks matter, so
+ *   flat or discontinuous error surfaces are handled. An elite ranks
+ *   above a candidate only when strictly better, so on a plateau the
+ *   search keeps moving, while the best sets found in earlier generations
+ *   keep pulling the center back when a generation is worse.
+ * - Merges every candidate better than the worst elite into the elite
+ *   archive.
+ *
+ * After every generation `net` holds the best elite, and epoch hooks run
+ * with σ reported as the learning rate; a hook may clone `net`, whose
+ * weights are then unshared again (see ownweights()) so the clone stays a
+ * snapshot. Stops once the best error is at or below
+ * `traindata_t::tolerance`, after `max_attempts` generations, or when the
+ * weights cannot be unshared.
+ */
+attempts_t evolvenet( net_s *net , traindata_t *train_data , const evolveconfig_s *config ){
+    evolveconfig_s settings= config ? *config : (evolveconfig_s){ 0 };
+    if( !settings.population ) settings.population= DEFAULT_POPULATION;
+    settings.population+= settings.population & 1;
+    if( !settings.elite ) settings.elite= 1;
+    if( !( settings.sigma > 0 ) ) settings.sigma= DEFAULT_SIGMA;
+    if( !train_data->in || !train_data->results || !ownweights( net ) ) return 0;
+    unsigned workers= settings.threads ? settings.threads : ntthreads( );
+    if( workers > settings.population ) workers= settings.population;
+    size_t params= 0;
+    for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) params+= (size_t)net->nn[i][j].inputs + 1;
+    const uint32_t population= settings.population, parents= population / 2, elites= settings.elite;
+    evolvejob_s job= { .net= net , .data= train_data , .params= params , .sigma= settings.sigma , .seed= settings.seed };
+    job.replicas= calloc( workers , sizeof( net_s ) );
+    job.inputs= calloc( workers , sizeof( data_t * ) );
+    job.error= malloc( population * sizeof( precision_t ) );
+    float *center= malloc( params * sizeof( float ) ), *step= malloc( params * sizeof( float ) ), *elite= malloc( (size_t)elites * params * sizeof( float ) );
+    precision_t *elite_error= malloc( elites * sizeof( precision_t ) );
+    uint32_t *order= malloc( population * sizeof( uint32_t ) );
+    double *weight= malloc( parents * sizeof( double ) );
+    attempts_t generation= 0;
+    unsigned built= 0;
+    if( job.replicas && job.inputs && job.error && center && step && elite && elite_error && order && weight ){
+        while( built < workers && replicate( &job.replicas[built] , net , &job.inputs[built] ) ) built++;
+    }
+    if( built && built == workers ){
+        job.center= center;
+        size_t p= 0;
+        for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
+            for( input_t k= 0 ; k < net->nn[i][j].inputs ; k++ ) center[p++]= net->nn[i][j].w[k];
+            center[p++]= net->nn[i][j].b;
+        }
+        double total= 0;
+        for( uint32_t r= 0 ; r < parents ; r++ ) total+= weight[r]= log( parents + 0.5 ) - log( r + 1.0 );
+        for( uint32_t r= 0 ; r < parents ; r++ ) weight[r]/= total;
+        setparams( &job.replicas[0] , center );
+        elite_error[0]= fitness( &job.replicas[0] , job.inputs[0] , train_data );
+        memcpy( elite , center , params * sizeof( float ) );
+        for( uint32_t e= 1 ; e < elites ; e++ ) elite_error[e]= INFINITY;
+        while( generation < train_data->max_attempts && elite_error[0] > train_data->tolerance ){
+            job.generation= generation;
+            ntparallel( population , workers , evaluaterange , &job );
+            for( uint32_t c= 0 ; c < population ; c++ ){
+                uint32_t r= c;
+                for( ; r && job.error[order[r - 1]] > job.error[c] ; r-- ) order[r]= order[r - 1];
+                order[r]= c;
+            }
+            memset( step , 0 , params * sizeof( float ) );
+            for( uint32_t r= 0 , c= 0 , e= 0 ; r < parents ; r++ ){
+                if( e < elites && elite_error[e] < job.error[order[c]] ){
+                    const float *x= elite + (size_t)e++ * params;
+                    for( size_t q= 0 ; q < params ; q++ ) step[q]+= (float)weight[r] * ( x[q] - center[q] );
+                    continue;
+                }
+                const uint64_t key= candidatekey( job.seed , generation , order[c] );
+                const float scale= (float)weight[r] * ( order[c] & 1 ? -job.sigma : job.sigma );
+                for( size_t q= 0 ; q < params ; q++ ) step[q]+= scale * noise( key , q );
+                c++;
+            }
+            for( uint32_t r= 0 ; r < population && job.error[order[r]] < elite_error[elites - 1] ; r++ ){
+                uint32_t e= elites - 1;
+                for( ; e && elite_error[e - 1] > job.error[order[r]] ; e-- ){
+                    elite_error[e]= elite_error[e - 1];
+                    memcpy( elite + (size_t)e * params , elite + (size_t)( e - 1 ) * params , params * sizeof( float ) );
+                }
+                elite_error[e]= job.error[order[r]];
+                writecandidate( &job , order[r] , NULL , elite + (size_t)e * params );
+            }
+            for( size_t q= 0 ; q < params ; q++ ) center[q]+= step[q];
+            setparams( net , elite );
+            trainstats_s stats= { .epoch= ++generation , .samples= train_data->samples , .error= elite_error[0] , .learning_rate= job.sigma };
+            for( trainhook_s *hook= train_data->hook ; hook ; hook= hook->next ) if( hook->epoch ) hook->epoch( net , &stats , hook->ctx );
+            if( !ownweights( net ) ) break;
+        }
+    }
+    for( unsigned w= 0 ; w < workers && job.replicas ; w++ ) deleteowner( &job.replicas[w] );
+    free( job.replicas );
+    free( job.inputs );
+    free( job.error );
+    free( center );
+    free( step );
+    free( elite );
+    free( elite_error );
+    free( order );
+    free( weight );
+    return generation;
+}
@@ -15,12 +15,23 @@
 #include "ntmemory.h"
 #include <stdlib.h>
 
+/**
+ * @details
+ * Arena bytes taken by one single-array 'M' wiring descriptor of `count`
+ * elements, in the same order the builders below request them.
+ */
+static size_t wiringplan( input_t count ){
+    return ARENA_SIZE( sizeof( type_t ) ) + ARENA_SIZE( sizeof( input_t ) ) + ARENA_SIZE( sizeof( type_t * ) ) + ARENA_SIZE( sizeof( layer_t * ) ) + ARENA_SIZE( sizeof( uint16_t * ) )
+        + ARENA_SIZE( count * sizeof( type_t ) ) + ARENA_SIZE( count * sizeof( layer_t ) ) + ARENA_SIZE( count * sizeof( uint16_t ) );
+}
+
 /**
  * @details
  * For each layer boundary, builds a single 'M'-type wiring array whose
  * slots enumerate every neuron of the current layer as an 'N' source, then
  * points every neuron of the next layer at that shared buffer (bff_idx = 0)
  * -- fully connecting each layer to only the one immediately preceding it.
+ * Every descriptor array comes from one arena slab sized up front.
  *
  * @retval NULL
  *  - `net` is NULL.
@@ -30,19 +41,22 @@ struct net_s *newfeedforward( net_s *net ){
     if( !net ) return NULL;
     if( !net->neurons ) return NULL;
     layer_t L= net->layers - 1;
+    size_t plan= 0;
+    for( layer_t i= 0 ; i < L ; i++ ) plan+= wiringplan( net->neurons[i] );
+    createarena( net , plan );
     for( layer_t i= 0 ; i < L ; i++ ){
         uint16_t count= net->neurons[i];
         net->wiring[i].arrays= 1;
-        net->wiring[i].array_type= createregister( net , malloc( sizeof( type_t ) ) );
+        net->wiring[i].array_type= arenaalloc( net , sizeof( type_t ) );
         net->wiring[i].array_type[0]= 'M';
-        net->wiring[i].size= createregister( net , malloc( sizeof( input_t ) ) );
+        net->wiring[i].size= arenaalloc( net , sizeof( input_t ) );
         net->wiring[i].size[0]= count;
-        net->wiring[i].src_type= createregister( net , malloc( sizeof( type_t * ) ) );
-        net->wiring[i].src_layer= createregister( net , malloc( sizeof( layer_t * ) ) );
-        net->wiring[i].src_index= createregister( net , malloc( sizeof( uint16_t * ) ) );
-        net->wiring[i].src_type[0]= createregister( net , malloc( count * sizeof( type_t ) ) );
-        net->wiring[i].src_layer[0]= createregister( net , malloc( count * sizeof( layer_t ) ) );
-        net->wiring[i].src_index[0]= createregister( net , malloc( count * sizeof( uint16_t ) ) );
+        net->wiring[i].src_type= arenaalloc( net , sizeof( type_t * ) );
+        net->wiring[i].src_layer= arenaalloc( net , sizeof( layer_t * ) );
+        net->wiring[i].src_index= arenaalloc( net , sizeof( uint16_t * ) );
+        net->wiring[i].src_type[0]= arenaalloc( net , count * sizeof( type_t ) );
+        net->wiring[i].src_layer[0]= arenaalloc( net , count * sizeof( layer_t ) );
+        net->wiring[i].src_index[0]= arenaalloc( net , count * sizeof( uint16_t ) );
         for( uint16_t j= 0 ; j < count ; j++ ){
             net->wiring[i].src_type[0][j]= 'N';
             net->wiring[i].src_layer[0][j]= i;
@@ -60,7 +74,8 @@ struct net_s *newfeedforward( net_s *net ){
  * current layer as an 'N' source -- the input set grows with each
  * boundary, so every layer ends up connected to all preceding layers, not
  * just the one immediately before it. Every neuron of the next layer is
- * pointed at that shared buffer (bff_idx = 0).
+ * pointed at that shared buffer (bff_idx = 0). Every descriptor array
+ * comes from one arena slab sized up front.
  *
  * @retval NULL
  *  - `net` is NULL.
@@ -71,19 +86,23 @@ struct net_s *newdense( net_s *net ){
     if( !net->neurons ) return NULL;
     layer_t L= net->layers - 1;
     input_t count= 0;
+    size_t plan= 0;
+    for( uint16_t i= 0 ; i < L ; i++ ) plan+= wiringplan( count+= net->neurons[i] );
+    createarena( net , plan );
+    count= 0;
     for( uint16_t i= 0 ; i < L ; i++ ){
         count+= net->neurons[i];
         net->wiring[i].arrays= 1;
-        net->wiring[i].array_type= createregister( net , malloc( sizeof( uint8_t ) ) );
+        net->wiring[i].array_type= arenaalloc( net , sizeof( uint8_t ) );
         net->wiring[i].array_type[0]= 'M';
-        net->wiring[i].size= createregister( net , malloc( sizeof( uint32_t ) ) );
+        net->wiring[i].size= arenaalloc( net , sizeof( uint32_t ) );
         net->wiring[i].size[0]= count;
-        net->wiring[i].src_type= createregister( net , malloc( sizeof( type_t * ) ) );
-        net->wiring[i].src_layer= createregister( net , malloc( sizeof( layer_t * ) ) );
-        net->wiring[i].src_index= createregister( net , malloc( sizeof( uint16_t * ) ) );
-        net->wiring[i].src_type[0]= createregister( net , malloc( count * sizeof( type_t ) ) );
-        net->wiring[i].src_layer[0]= createregister( net , malloc( count * sizeof( layer_t ) ) );
-        net->wiring[i].src_index[0]= createregister( net , malloc( count * sizeof( uint16_t ) ) );
+        net->wiring[i].src_type= arenaalloc( net , sizeof( type_t * ) );
+        net->wiring[i].src_layer= arenaalloc( net , sizeof( layer_t * ) );
+        net->wiring[i].src_index= arenaalloc( net , sizeof( uint16_t * ) );
+        net->wiring[i].src_type[0]= arenaalloc( net , count * sizeof( type_t ) );
+        net->wiring[i].src_layer[0]= arenaalloc( net , count * sizeof( layer_t ) );
+        net->wiring[i].src_index[0]= arenaalloc( net , count * sizeof( uint16_t ) );
         layer_t layer= 0;
         uint16_t index= 0;
         for( input_t j= 0 ; j < count ; j++ ){
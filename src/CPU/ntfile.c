@@ -4,40 +4,82 @@
  * 
  * Provides functions to persist network structures and weights, allowing training to be stored and reloaded.  
  * The file format is binary with a custom structure, including endianness and floating-point representation handling for cross-platform compatibility.  
- * Currently, the implementation focuses on core data serialization and deserialization, with future plans for validation and standardization of loaded data.
+ * Currently, the implementation focuses on core data serialization and deserialization, with future plans for standardization of loaded data.
  * 
- * @todo Consider adding support for versioning in the file format to allow for future extensions and backward compatibility.
- * @todo Explore options for compressing the saved network files to reduce disk space usage, especially for larger networks.
+ * Version 1 files keep the weights apart from the rest, in one aligned block of little-endian IEEE 754 rows laid out exactly as
+ * buildnet() lays them out in memory, so that on a matching host loadnet() maps the block and uses it in place. Version 0 files,
+ * which interleave every weight with its neuron's activation and bias, still load.
+ *
+ * The same bytes can be saved to and loaded from a path, a `FILE *`, a file descriptor, a caller's buffer, or reader and writer
+ * callbacks. All of them go through one buffered serializer that converts whole rows at a time, so on a little-endian IEEE 754
+ * host weights move with plain block copies.
+ *
+ * Version 2 files are compressed for storage and distribution: wiring is run-length encoded, so regular patterns such as
+ * fully-connected layers shrink to a few bytes; biases and weights are split into byte planes, which groups their slowly
+ * varying sign and exponent bytes; and the result is packed with ntpack(). Loading one decompresses it in a single pass of
+ * copies, bounded by the declared sizes.
+ *
+ * Every version is checked before it is built: sizes are bounded by the input that remains, when its length is known, and
+ * every neuron, buffer, input, output and activation a file refers to must exist (see checknet()), so a corrupt or hostile
+ * file is rejected with an error code instead of being followed.
  * 
  * @author Oscar Sotomayor
  * @date 2026
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "ntfile.h"
+#include "ntactivation.h"
 #include "ntbuilder.h"
+#include "ntcodec.h"
 #include "ntmemory.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
 #include <float.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-#define NAME_LENGTH 50
 #define MAGIC "NeuroTIC"
-#define VERSION 0x0
+#define VERSION 0x1
+
+/** Version whose weights are interleaved with activations and biases; still loaded. */
+#define VERSION_STREAM 0x0
+
+/** Compressed version, written by the savenet_packed() family. */
+#define VERSION_PACKED 0x2
+
+/** Size of a version 2 header: magic string, version byte, and the unpacked and packed payload sizes. */
+#define PACKED_HEADER ( sizeof( MAGIC ) + 2 * sizeof( uint64_t ) )
+
+/** Alignment of a version 1 weight block within its file. */
+#define WEIGHT_ALIGN 64
+
+/** Size of the staging buffer the stream, `FILE *` and descriptor variants move data through. */
+#define STREAM_BLOCK ( (size_t)1 << 16 )
+
+/** Floats converted per pass when a host needs byte swapping or a non-IEEE conversion. */
+#define CONVERT_BATCH 256
+
+#if ARENA_ALIGN != 16
+#error "version 1 files pad weight rows to 16 bytes, as arenas did when the format was defined"
+#endif
 
 /**
  * @name Endianness and Floating-Point Handling
  * 
- * The STRICT_LE16 and STRICT_LE32 macros ensure that data is written in little-endian format, regardless of the host system's endianness.  
- * The checkendian function detects the system's endianness, while bswap16 and bswap32 perform byte swapping for 16-bit and 32-bit integers, respectively.  
+ * The checkendian function detects the system's endianness, while bswap16, bswap32 and bswap64 perform byte swapping for 16-, 32- and 64-bit integers,
+ * respectively; the serializer below uses them to keep every field little-endian regardless of the host.  
  * The isieee754 function checks if the system uses IEEE 754 floating-point representation, and the float32 and floatsys functions convert between
  * float and uint32_t representations based on the IEEE 754 standard or a custom format if not supported.
  * 
  * @code
  */
-#define STRICT_LE16( x ) &( uint16_t ){ little_endian ? ( x ) : bswap16( x )}
-#define STRICT_LE32( x ) &( uint32_t ){ little_endian ? ( x ) : bswap32( x )}
 uint8_t checkendian( void ){
     uint16_t x= 1;
     return *(uint8_t *)&x;
@@ -52,6 +94,9 @@ uint32_t bswap32( uint32_t x ){
         ( ( x << 8 ) & 0xFF0000 ) |
         ( ( x << 24 ) & 0xFF000000 );
 }
+uint64_t bswap64( uint64_t x ){
+    return ( (uint64_t)bswap32( (uint32_t)x ) << 32 ) | bswap32( (uint32_t)( x >> 32 ) );
+}
 
 uint8_t isieee754( void ){
     return
@@ -100,186 +145,1094 @@ float floatsys( int32_t x , uint8_t ieee754 ){
 /** @endcode */
 
 /**
- * @retval 0
- *  - the resulting filename (`name` + ".ntic") exceeds the internal buffer size.
- *  - the file could not be opened for writing.
+ * @details
+ * Output of one serialization. Bytes are staged in `buf` and handed to
+ * `sink` whenever it fills. Without a sink `buf` is the destination
+ * itself; once it is full, further bytes are only counted, so `total`
+ * still tells how large a buffer the network needs.
+ */
+typedef struct ntwriter_s {
+    unsigned char   *buf;
+    size_t          capacity;
+    size_t          used;           /**< Bytes of `buf` in use. */
+    size_t          total;          /**< Bytes emitted so far, stored or not. */
+    ntwrite_f       sink;
+    void            *ctx;
+    uint8_t         failed;         /**< The sink refused bytes, or the destination was too small. */
+    uint8_t         little_endian;
+    uint8_t         ieee754;
+} ntwriter_s;
+
+/**
+ * @details
+ * Input of one deserialization: `buf[at..size)` are the bytes not yet
+ * consumed. With a `source`, `buf` is the staging `block`, refilled
+ * whenever it runs out; without one, `buf` is the whole input.
+ */
+typedef struct ntreader_s {
+    const unsigned char *buf;
+    size_t          size;
+    size_t          at;
+    size_t          offset;         /**< Input position of `buf[0]`. */
+    ntread_f        source;
+    void            *ctx;
+    unsigned char   *block;
+    uint8_t         failed;         /**< The input ended early. */
+    uint8_t         swap;           /**< Host is big-endian. */
+    uint8_t         ieee754;
+} ntreader_s;
+
+/**
+ * @details
+ * Hands the staged bytes to the writer's sink.
+ */
+static void flushwriter( ntwriter_s *w ){
+    if( !w->sink ) return;
+    if( w->used && !w->failed && w->sink( w->ctx , w->buf , w->used ) != w->used ) w->failed= 1;
+    w->used= 0;
+}
+
+/**
+ * @details
+ * Emits `size` bytes from `data`, or zeros when `data` is NULL. With a
+ * sink and nothing staged, a request of a whole block or more bypasses
+ * the staging buffer.
+ */
+static void putbytes( ntwriter_s *w , const void *data , size_t size ){
+    const unsigned char *from= data;
+    w->total+= size;
+    if( from && w->sink && !w->used && size >= w->capacity ){
+        if( !w->failed && w->sink( w->ctx , from , size ) != size ) w->failed= 1;
+        return;
+    }
+    while( size && !w->failed ){
+        if( w->used == w->capacity ){
+            if( !w->sink ) w->failed= 1;
+            flushwriter( w );
+            continue;
+        }
+        const size_t n= size < w->capacity - w->used ? size : w->capacity - w->used;
+        if( from ) memcpy( w->buf + w->used , from , n );
+        else memset( w->buf + w->used , 0 , n );
+        if( from ) from+= n;
+        w->used+= n;
+        size-= n;
+    }
+}
+
+static void put8( ntwriter_s *w , uint8_t x ){
+    putbytes( w , &x , sizeof( x ) );
+}
+static void put16( ntwriter_s *w , uint16_t x ){
+    if( !w->little_endian ) x= bswap16( x );
+    putbytes( w , &x , sizeof( x ) );
+}
+static void put32( ntwriter_s *w , uint32_t x ){
+    if( !w->little_endian ) x= bswap32( x );
+    putbytes( w , &x , sizeof( x ) );
+}
+static void put64( ntwriter_s *w , uint64_t x ){
+    if( !w->little_endian ) x= bswap64( x );
+    putbytes( w , &x , sizeof( x ) );
+}
+
+/**
+ * @details
+ * Emits `n` floats as little-endian IEEE 754: copied as they are on a
+ * little-endian IEEE host, otherwise converted @ref CONVERT_BATCH at a
+ * time.
+ */
+static void putfloats( ntwriter_s *w , const float *x , size_t n ){
+    if( w->little_endian && w->ieee754 ){
+        putbytes( w , x , n * sizeof( float ) );
+        return;
+    }
+    uint32_t batch[CONVERT_BATCH];
+    for( size_t k= 0 ; k < n ; ){
+        const size_t m= n - k < CONVERT_BATCH ? n - k : CONVERT_BATCH;
+        for( size_t q= 0 ; q < m ; q++ ){
+            const uint32_t v= float32( x[k + q] , w->ieee754 );
+            batch[q]= w->little_endian ? v : bswap32( v );
+        }
+        putbytes( w , batch , m * sizeof( uint32_t ) );
+        k+= m;
+    }
+}
+
+/**
+ * @details
+ * Consumes `size` bytes into `data`, or skips them when `data` is NULL.
+ * With a source and nothing left staged, a request of a whole block or
+ * more is read straight into `data`. Sets the failure flag, and returns
+ * 0, if the input ends first.
+ */
+static uint8_t getbytes( ntreader_s *r , void *data , size_t size ){
+    unsigned char *to= data;
+    while( size && !r->failed ){
+        if( r->at == r->size ){
+            r->offset+= r->size;
+            r->at= r->size= 0;
+            if( !r->source ) r->failed= 1;
+            else if( to && size >= STREAM_BLOCK ){
+                const size_t n= r->source( r->ctx , to , size );
+                r->offset+= n;
+                to+= n;
+                size-= n;
+                if( !n ) r->failed= 1;
+            }
+            else if( !( r->size= r->source( r->ctx , r->block , STREAM_BLOCK ) ) ) r->failed= 1;
+            r->buf= r->block;
+            continue;
+        }
+        const size_t n= size < r->size - r->at ? size : r->size - r->at;
+        if( to ){
+            memcpy( to , r->buf + r->at , n );
+            to+= n;
+        }
+        r->at+= n;
+        size-= n;
+    }
+    return !r->failed;
+}
+
+static uint8_t get8( ntreader_s *r ){
+    uint8_t x= 0;
+    getbytes( r , &x , sizeof( x ) );
+    return x;
+}
+static uint16_t get16( ntreader_s *r ){
+    uint16_t x= 0;
+    getbytes( r , &x , sizeof( x ) );
+    return r->swap ? bswap16( x ) : x;
+}
+static uint32_t get32( ntreader_s *r ){
+    uint32_t x= 0;
+    getbytes( r , &x , sizeof( x ) );
+    return r->swap ? bswap32( x ) : x;
+}
+static uint64_t get64( ntreader_s *r ){
+    uint64_t x= 0;
+    getbytes( r , &x , sizeof( x ) );
+    return r->swap ? bswap64( x ) : x;
+}
+
+/**
+ * @details
+ * Consumes `n` little-endian IEEE 754 floats into `x` with one bulk
+ * copy, then converts them in place unless the host already matches.
+ */
+static void getfloats( ntreader_s *r , float *x , size_t n ){
+    if( !getbytes( r , x , n * sizeof( float ) ) || ( !r->swap && r->ieee754 ) ) return;
+    for( size_t k= 0 ; k < n ; k++ ){
+        uint32_t v;
+        memcpy( &v , &x[k] , sizeof( v ) );
+        x[k]= floatsys( (int32_t)( r->swap ? bswap32( v ) : v ) , r->ieee754 );
+    }
+}
+
+/**
+ * @retval 1 `count` items of at least `each` bytes apiece may still lie in
+ *           the input: it is a stream, whose length is unknown, or its
+ *           unread bytes could hold them.
+ * @retval 0 they cannot.
  *
  * @details
- * Saves the network's layers, neurons, weights, biases, and buffer wiring to a binary file.  
- * The file is structured with a header containing a magic string and version byte, followed by the network's core data.  
- * The function handles endianness and floating-point representation to ensure cross-platform compatibility.  
- * 
- * @todo Add validation checks for the input network structure before attempting to save, ensuring that all necessary data is present and correctly formatted.  
- * @todo Implement error handling for file operations, such as checking for write permissions and handling disk space issues.  
- * @todo Consider adding metadata to the file format, such as timestamps or training information, to provide more context when loading networks in the future.  
+ * Bounds a size read from an input before memory is allocated for it, so
+ * that a corrupt count is rejected instead of allocating, and zeroing,
+ * whatever it claims.
+ */
+static uint8_t fits( const ntreader_s *r , uint64_t count , size_t each ){
+    return r->source || count <= ( r->size - r->at ) / each;
+}
+
+/**
+ * @details
+ * Emits `x` as an unsigned LEB128 varint: 7 bits per byte, low bits
+ * first, the top bit set on every byte but the last.
+ */
+static void putvarint( ntwriter_s *w , uint64_t x ){
+    unsigned char b[10];
+    size_t n= 0;
+    do{
+        b[n++]= (unsigned char)( ( x & 0x7F ) | ( x > 0x7F ? 0x80 : 0 ) );
+        x>>= 7;
+    } while( x );
+    putbytes( w , b , n );
+}
+
+/**
+ * @details
+ * Consumes a varint written by putvarint(), failing the reader on one
+ * longer than 64 bits.
+ */
+static uint64_t getvarint( ntreader_s *r ){
+    uint64_t x= 0;
+    for( unsigned shift= 0 ; shift < 64 ; shift+= 7 ){
+        const uint8_t b= get8( r );
+        x|= (uint64_t)( b & 0x7F ) << shift;
+        if( !( b & 0x80 ) ) return x;
+    }
+    r->failed= 1;
+    return 0;
+}
+
+/**
+ * @details
+ * Emits byte `plane` of the little-endian IEEE 754 encoding of each of
+ * the `n` floats at `x`, @ref CONVERT_BATCH at a time.
  */
-size_t savenet( net_s * net , const char *name ){
-    uint8_t little_endian= checkendian( ) , ieee754= isieee754( );
-    char NAME[ NAME_LENGTH ];
-    size_t file_size= 0;
-    if( snprintf( NAME , sizeof( NAME ) , "%s%s" , name , ".ntic" ) >= ( int )sizeof( NAME ) ) return file_size;
-    FILE *fp= fopen( NAME , "wb" );
-    if( fp == NULL ) return file_size;
-    fprintf( fp , "%s%c" , MAGIC , VERSION );
-    fwrite( STRICT_LE32( net->inputs ) , sizeof( input_t ) , 1 , fp );
-    fwrite( STRICT_LE32( net->layers ) , sizeof( layer_t ) , 1 , fp );
-    for( layer_t i= 0 ; i < net->layers ; i ++ ) fwrite( STRICT_LE16( net->neurons[i] ) , sizeof( uint16_t ) , 1 , fp );
+static void putplane( ntwriter_s *w , const float *x , size_t n , unsigned plane ){
+    uint8_t batch[CONVERT_BATCH];
+    for( size_t k= 0 ; k < n ; ){
+        const size_t m= n - k < CONVERT_BATCH ? n - k : CONVERT_BATCH;
+        for( size_t q= 0 ; q < m ; q++ ) batch[q]= (uint8_t)( float32( x[k + q] , w->ieee754 ) >> ( 8 * plane ) );
+        putbytes( w , batch , m );
+        k+= m;
+    }
+}
+
+/**
+ * @retval 0 the descriptors could not be allocated.
+ *
+ * @details
+ * Allocates the per-array descriptors of wiring transition `i`, for
+ * net_s::wiring[i].arrays arrays.
+ */
+static int wiringarrays( net_s *net , uint16_t i ){
+    net->wiring[i].array_type= arenaalloc( net , net->wiring[i].arrays * sizeof( uint8_t ) );
+    net->wiring[i].size= arenaalloc( net , net->wiring[i].arrays * sizeof( uint32_t ) );
+    net->wiring[i].src_type= arenaalloc( net , net->wiring[i].arrays * sizeof( uint8_t * ) );
+    net->wiring[i].src_layer= arenaalloc( net , net->wiring[i].arrays * sizeof( uint16_t * ) );
+    net->wiring[i].src_index= arenaalloc( net , net->wiring[i].arrays * sizeof( uint16_t * ) );
+    return net->wiring[i].array_type && net->wiring[i].size && net->wiring[i].src_type && net->wiring[i].src_layer && net->wiring[i].src_index;
+}
+
+/**
+ * @retval 0 the sources could not be allocated.
+ *
+ * @details
+ * Allocates the `size` element sources of array `j` of wiring
+ * transition `i`.
+ */
+static int wiringsources( net_s *net , uint16_t i , uint16_t j , uint32_t size ){
+    net->wiring[i].src_type[j]= arenaalloc( net , size * sizeof( uint8_t ) );
+    net->wiring[i].src_layer[j]= arenaalloc( net , size * sizeof( uint16_t ) );
+    net->wiring[i].src_index[j]= arenaalloc( net , size * sizeof( uint16_t ) );
+    return net->wiring[i].src_type[j] && net->wiring[i].src_layer[j] && net->wiring[i].src_index[j];
+}
+
+/**
+ * @retval 1 array `j` of wiring transition `i` resolves to a buffer.
+ * @retval 0 it does not: it lies out of range, has a type buildnet()
+ *           leaves `NULL`, or is an 'N' alias of such an array or of an
+ *           alias not resolved before it.
+ *
+ * @details
+ * buildnet() resolves 'M' arrays first, then every other array in order,
+ * so an alias may only name an 'M' array or one that precedes it.
+ */
+static int resolvable( const net_s *net , uint16_t i , uint16_t j ){
+    if( i + 1 >= net->layers || j >= net->wiring[i].arrays ) return 0;
+    while( net->wiring[i].array_type[j] == 'N' ){
+        const uint16_t l= net->wiring[i].src_layer[j][0], m= net->wiring[i].src_index[j][0];
+        if( l + 1 >= net->layers || m >= net->wiring[l].arrays ) return 0;
+        if( net->wiring[l].array_type[m] != 'M' && ( l > i || ( l == i && m >= j ) ) ) return 0;
+        i= l;
+        j= m;
+    }
+    return net->wiring[i].array_type[j] == 'M' || net->wiring[i].array_type[j] == 'I' || net->wiring[i].array_type[j] == 'O';
+}
+
+/**
+ * @retval 1 `net`'s structure, as read from a file, can be built.
+ * @retval 0 it names something that does not exist.
+ *
+ * @details
+ * Checks, before buildnet() follows them, every reference a file
+ * supplies: each first-layer neuron reads exactly net_s::inputs values;
+ * each later neuron selects a buffer that resolves (see resolvable());
+ * and each 'M' element is of type 'N', 'O' or 'I' and names an existing
+ * neuron, output or input. Activations are checked as they are read.
+ */
+static int checknet( const net_s *net ){
+    for( uint16_t j= 0 ; j < net->neurons[0] ; j++ ) if( net->nn[0][j].inputs != net->inputs ) return 0;
+    for( uint16_t i= 1 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) if( !resolvable( net , i - 1 , net->nn[i][j].bff_idx ) ) return 0;
+    for( uint16_t i= 0 ; i + 1 < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->wiring[i].arrays ; j++ ){
+        if( net->wiring[i].array_type[j] != 'M' ) continue;
+        for( uint32_t k= 0 ; k < net->wiring[i].size[j] ; k++ ){
+            const uint16_t layer= net->wiring[i].src_layer[j][k], index= net->wiring[i].src_index[j][k];
+            switch( net->wiring[i].src_type[j][k] ){
+                case 'N':
+                    if( layer >= net->layers || index >= net->neurons[layer] ) return 0;
+                    break;
+                case 'O':
+                    if( index >= net->neurons[net->layers - 1] ) return 0;
+                    break;
+                case 'I':
+                    if( index >= net->inputs ) return 0;
+                    break;
+                default:
+                    return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @retval 1 buildnet() could not allocate the weight block: some neuron
+ *           with inputs was left without a row.
+ */
+static int unbuilt( const net_s *net ){
+    for( uint16_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) if( net->nn[i][j].inputs && !net->nn[i][j].w ) return 1;
+    return 0;
+}
+
+/**
+ * @details
+ * Serializes `net` as a version 1 file: magic string and version byte;
+ * input and layer counts; every layer's neuron count; every neuron's
+ * input count and buffer index; the wiring of every layer transition;
+ * every neuron's activation and bias; then the 64-bit offset and size of
+ * the weight block, zero padding up to that offset -- a multiple of
+ * @ref WEIGHT_ALIGN, leaving at least @ref SHARED_HEADER bytes of
+ * padding -- and the block itself: every neuron's weights in order, each
+ * row zero-padded to @ref ARENA_SIZE.
+ */
+static void writenet( ntwriter_s *w , const net_s *net ){
+    putbytes( w , MAGIC , sizeof( MAGIC ) - 1 );
+    put8( w , VERSION );
+    put32( w , net->inputs );
+    put16( w , net->layers );
+    for( layer_t i= 0 ; i < net->layers ; i ++ ) put16( w , net->neurons[i] );
     for( layer_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
-        fwrite( STRICT_LE32( net->nn[i][j].inputs ) , sizeof( input_t ) , 1 , fp );
-        fwrite( &net->nn[i][j].bff_idx , sizeof( index_t ) , 1 , fp );
+        put32( w , net->nn[i][j].inputs );
+        put8( w , net->nn[i][j].bff_idx );
     }
     if( net->layers > 1 ) for( layer_t i= 0 ; i < net->layers - 1 ; i++ ){
-        fwrite( &net->wiring[i].arrays , sizeof( index_t ) , 1 , fp );
+        put8( w , net->wiring[i].arrays );
         for( index_t j= 0 ; j < net->wiring[i].arrays ; j++ ){
-            fwrite( &net->wiring[i].array_type[j] , sizeof( type_t ) , 1 , fp );
+            put8( w , net->wiring[i].array_type[j] );
             switch( net->wiring[i].array_type[j] ){
                 case 'M':
-                    fwrite( STRICT_LE32( net->wiring[i].size[j] ) , sizeof( input_t ) , 1 , fp );
+                    put32( w , net->wiring[i].size[j] );
                     for( input_t k= 0 ; k < net->wiring[i].size[j] ; k++ ){
-                        fwrite( &net->wiring[i].src_type[j][k] , sizeof( type_t ) , 1 , fp );
+                        put8( w , net->wiring[i].src_type[j][k] );
                         switch( net->wiring[i].src_type[j][k] ){
                         case 'N':
-                            fwrite( STRICT_LE16( net->wiring[i].src_layer[j][k] ) , sizeof( layer_t ) , 1 , fp );
-                            fwrite( STRICT_LE16( net->wiring[i].src_index[j][k] ) , sizeof( uint16_t ) , 1 , fp );
+                            put16( w , net->wiring[i].src_layer[j][k] );
+                            put16( w , net->wiring[i].src_index[j][k] );
                             break;
                         case 'O':
                         case 'I':
-                            fwrite( STRICT_LE16( net->wiring[i].src_index[j][k] ) , sizeof( uint16_t ) , 1 , fp );
+                            put16( w , net->wiring[i].src_index[j][k] );
                         }
                     }
                     break;
                 case 'N':
-                    fwrite( STRICT_LE16( net->wiring[i].src_layer[j][0] ) , sizeof( layer_t ) , 1 , fp );
-                    fwrite( STRICT_LE16( net->wiring[i].src_index[j][0] ) , sizeof( uint16_t ) , 1 , fp );
+                    put16( w , net->wiring[i].src_layer[j][0] );
+                    put16( w , net->wiring[i].src_index[j][0] );
                     break;
             }
         }
     }
+    uint64_t weights= 0;
     for( layer_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
-        fwrite( &net->nn[i][j].fn , sizeof( index_t ) , 1 , fp );
-        fwrite( STRICT_LE32( float32( net->nn[i][j].b , ieee754 ) ) , sizeof( data_t ) , 1 , fp );
-        for( input_t k= 0 ; k < net->nn[i][j].inputs ; k++ ) fwrite( STRICT_LE32( float32( net->nn[i][j].w[k] , ieee754 ) ) , sizeof( data_t ) , 1 , fp );
+        put8( w , net->nn[i][j].fn );
+        put32( w , float32( net->nn[i][j].b , w->ieee754 ) );
+        weights+= ARENA_SIZE( net->nn[i][j].inputs * sizeof( weight_t ) );
+    }
+    const uint64_t offset= ( (uint64_t)w->total + 2 * sizeof( uint64_t ) + SHARED_HEADER + WEIGHT_ALIGN - 1 ) & ~(uint64_t)( WEIGHT_ALIGN - 1 );
+    put64( w , offset );
+    put64( w , weights );
+    putbytes( w , NULL , offset - w->total );
+    for( layer_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
+        putfloats( w , net->nn[i][j].w , net->nn[i][j].inputs );
+        putbytes( w , NULL , ARENA_SIZE( net->nn[i][j].inputs * sizeof( weight_t ) ) - net->nn[i][j].inputs * sizeof( weight_t ) );
     }
-    fseek( fp , 0 , SEEK_END );
-    file_size= ftell( fp );
-    fclose( fp );
-    return file_size;
 }
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-result"
+/**
+ * @details
+ * Runs writenet() into `w`, then flushes it.
+ */
+static size_t finishwrite( ntwriter_s *w , const net_s *net ){
+    w->little_endian= checkendian( );
+    w->ieee754= isieee754( );
+    writenet( w , net );
+    flushwriter( w );
+    return w->failed ? 0 : w->total;
+}
 
 /**
- * @retval 1 the resulting filename (`name` + ".ntic") exceeds the internal buffer size.
- * @retval 2 the file could not be opened for reading.
- * @retval 3 the file's magic string or version byte does not match what this module writes.
- * @retval 4 the network's base structure could not be built from the file's header data.
+ * @retval 0
+ *  - `net` or `write` is NULL.
+ *  - the staging buffer could not be allocated.
+ *  - `write` accepted fewer bytes than it was given.
  *
  * @details
- * Reconstructs the network structure, weights, biases, and buffer wiring from a binary file.  
- * The function reads the file header to validate the format and version, then proceeds to read the core network data while handling endianness and floating-point representation.
- * 
- * @todo Implement file validation and data standardization during loading to ensure compatibility and integrity of loaded networks.
+ * Serializes the network's layers, neurons, weights, biases, and buffer wiring, in the version 1 layout (see writenet()),
+ * through `write`, in chunks of up to @ref STREAM_BLOCK bytes. Every field is converted to little-endian IEEE 754 in bulk,
+ * and on a host that already matches, weight rows are passed on without any conversion.
  */
-size_t loadnet( net_s *net , const char *name ){
-    size_t err_val= 0;
-    FILE *fp= NULL;
-    uint16_t *neurons= NULL;
-    uint8_t little_endian= !checkendian( ) , ieee754= isieee754( );
-    char NAME[ NAME_LENGTH ];
-    if( snprintf( NAME , sizeof( NAME ) , "%s%s" , name , ".ntic" ) >= ( int )sizeof( NAME ) ){
-        err_val= 1;
-        goto EXIT;
-    }
-    fp= fopen( NAME , "rb" );
-    if( fp == NULL ){
-        err_val= 2;
-        goto EXIT;
+size_t savenet_stream( net_s *net , ntwrite_f write , void *ctx ){
+    if( !net || !write ) return 0;
+    ntwriter_s w= { .buf= malloc( STREAM_BLOCK ) , .capacity= STREAM_BLOCK , .sink= write , .ctx= ctx };
+    if( !w.buf ) return 0;
+    const size_t size= finishwrite( &w , net );
+    free( w.buf );
+    return size;
+}
+
+/**
+ * @retval 0 `net` is NULL.
+ *
+ * @details
+ * Serializes the network straight into `buffer`, with no intermediate copy. Returns the serialized size even when it exceeds
+ * `capacity`, in which case only the first `capacity` bytes were written: calling it with a NULL `buffer` and a zero
+ * `capacity` measures the buffer a network needs.
+ */
+size_t savenet_mem( net_s *net , void *buffer , size_t capacity ){
+    if( !net ) return 0;
+    ntwriter_s w= { .buf= buffer , .capacity= buffer ? capacity : 0 };
+    finishwrite( &w , net );
+    return w.total;
+}
+
+/**
+ * @details
+ * ntwrite_f over a `FILE *`.
+ */
+static size_t writefile( void *ctx , const void *data , size_t size ){
+    return fwrite( data , 1 , size , ctx );
+}
+
+/**
+ * @retval 0 `fp` is NULL, or writing to it failed.
+ *
+ * @details
+ * savenet_stream() into `fp`, from its current position. The stream is not flushed or closed.
+ */
+size_t savenet_file( net_s *net , FILE *fp ){
+    return fp ? savenet_stream( net , writefile , fp ) : 0;
+}
+
+/**
+ * @details
+ * ntwrite_f over a file descriptor, retrying short and interrupted
+ * writes.
+ */
+static size_t writefd( void *ctx , const void *data , size_t size ){
+    const int fd= *(const int *)ctx;
+    size_t done= 0;
+    while( done < size ){
+        const ssize_t n= write( fd , (const unsigned char *)data + done , size - done );
+        if( n < 0 && errno == EINTR ) continue;
+        if( n <= 0 ) break;
+        done+= (size_t)n;
     }
-    char magic[sizeof( MAGIC )];
-    fread( magic , sizeof( char ) , sizeof( magic ) , fp );
-    if( strncmp( magic , MAGIC , sizeof( MAGIC ) - 1 ) || magic[sizeof( magic ) - 1] != VERSION ){
-        err_val= 3;
-        goto EXIT;
-    }
-    fread( &net->inputs , sizeof( uint32_t ) , 1 , fp );
-    if( little_endian ) net->inputs= bswap32( net->inputs );
-    fread( &net->layers , sizeof( uint16_t ) , 1 , fp );
-    if( little_endian ) net->layers= bswap16( net->layers );
-    neurons= calloc( net->layers , sizeof( uint16_t ) );
-    fread( neurons , sizeof( uint16_t ) , net->layers , fp );
-    if( little_endian ) for( uint16_t i= 0 ; i < net->layers ; i++ ) neurons[i]= bswap16( neurons[i] );
-    if( !newnet( net , neurons , net->layers ) ){
-        err_val= 4;
-        goto EXIT;
+    return done;
+}
+
+/**
+ * @retval 0 writing to `fd` failed.
+ *
+ * @details
+ * savenet_stream() into the file descriptor `fd`, from its current position.
+ */
+size_t savenet_fd( net_s *net , int fd ){
+    return savenet_stream( net , writefd , &fd );
+}
+
+/**
+ * @details
+ * Writes the network with `save` into `name` + ".ntic.tmp", then renames it over `name` + ".ntic". A file that is being
+ * replaced is never truncated: a network loaded from it keeps its weights mapped (see loadnet_fd()), so saving it back to
+ * the same name stays safe, and a failed save leaves the previous file as it was.
+ */
+static size_t savepath( net_s *net , const char *name , size_t ( *save )( net_s * , ntwrite_f , void * ) ){
+    const size_t length= strlen( name );
+    char *path= malloc( 2 * length + sizeof( ".ntic" ) + sizeof( ".ntic.tmp" ) );
+    if( !path ) return 0;
+    char *tmp= path + length + sizeof( ".ntic" );
+    strcat( strcpy( path , name ) , ".ntic" );
+    strcat( strcpy( tmp , name ) , ".ntic.tmp" );
+    size_t size= 0;
+    FILE *fp= fopen( tmp , "wb" );
+    if( fp ){
+        size= save( net , writefile , fp );
+        if( fclose( fp ) ) size= 0;
+        if( size && rename( tmp , path ) ) size= 0;
+        if( !size ) remove( tmp );
+    }
+    free( path );
+    return size;
+}
+
+/**
+ * @retval 0
+ *  - the filename (`name` + ".ntic") could not be allocated.
+ *  - the file could not be opened, written, closed, or renamed into place.
+ *
+ * @details
+ * savenet_stream() into `name` + ".ntic.tmp", renamed over `name` + ".ntic" once complete (see savepath()). The filename
+ * has no length limit of its own.
+ *
+ * @todo Add validation checks for the input network structure before attempting to save, ensuring that all necessary data is present and correctly formatted.  
+ * @todo Consider adding metadata to the file format, such as timestamps or training information, to provide more context when loading networks in the future.  
+ */
+size_t savenet( net_s *net , const char *name ){
+    return savepath( net , name , savenet_stream );
+}
+
+/**
+ * @details
+ * Emits the sources of 'M' array `j` of wiring transition `i` as runs:
+ * elements sharing a source type (and, for 'N', a source layer) whose
+ * indices advance by a constant step. Each run is its type, its length,
+ * for 'N' the layer, for 'N', 'O' and 'I' the first index, and when
+ * longer than one element the step, zigzag encoded. A fully-connected
+ * array is a single run.
+ */
+static void putsources( ntwriter_s *w , const net_s *net , layer_t i , index_t j ){
+    const type_t *type= net->wiring[i].src_type[j];
+    const uint16_t *layer= net->wiring[i].src_layer[j], *index= net->wiring[i].src_index[j];
+    for( input_t k= 0 , q ; k < net->wiring[i].size[j] ; k= q ){
+        const uint8_t indexed= type[k] == 'N' || type[k] == 'O' || type[k] == 'I';
+        const int64_t step= k + 1 < net->wiring[i].size[j] ? (int64_t)index[k + 1] - index[k] : 0;
+        for( q= k + 1 ; q < net->wiring[i].size[j] && type[q] == type[k] && ( type[k] != 'N' || layer[q] == layer[k] ) && ( !indexed || (int64_t)index[q] - index[q - 1] == step ) ; q++ );
+        put8( w , type[k] );
+        putvarint( w , q - k );
+        if( type[k] == 'N' ) putvarint( w , layer[k] );
+        if( indexed ) putvarint( w , index[k] );
+        if( indexed && q - k > 1 ) putvarint( w , step < 0 ? ( (uint64_t)-step << 1 ) - 1 : (uint64_t)step << 1 );
+    }
+}
+
+/**
+ * @details
+ * Serializes `net` as the payload of a version 2 file, in the order of
+ * writenet() but with every count a varint: neuron shapes -- input
+ * count and buffer index -- as runs of identical neurons per layer;
+ * wiring, with 'M' arrays through putsources(); activations as runs;
+ * then every bias and every weight, without row padding, split into
+ * four byte planes from the lowest byte up.
+ */
+static void writepacked( ntwriter_s *w , const net_s *net ){
+    putvarint( w , net->inputs );
+    putvarint( w , net->layers );
+    for( layer_t i= 0 ; i < net->layers ; i ++ ) putvarint( w , net->neurons[i] );
+    for( layer_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 , k ; j < net->neurons[i] ; j= k ){
+        for( k= j + 1 ; k < net->neurons[i] && net->nn[i][k].inputs == net->nn[i][j].inputs && net->nn[i][k].bff_idx == net->nn[i][j].bff_idx ; k++ );
+        putvarint( w , k - j );
+        putvarint( w , net->nn[i][j].inputs );
+        put8( w , net->nn[i][j].bff_idx );
+    }
+    if( net->layers > 1 ) for( layer_t i= 0 ; i < net->layers - 1 ; i++ ){
+        put8( w , net->wiring[i].arrays );
+        for( index_t j= 0 ; j < net->wiring[i].arrays ; j++ ){
+            put8( w , net->wiring[i].array_type[j] );
+            switch( net->wiring[i].array_type[j] ){
+                case 'M':
+                    putvarint( w , net->wiring[i].size[j] );
+                    putsources( w , net , i , j );
+                    break;
+                case 'N':
+                    putvarint( w , net->wiring[i].src_layer[j][0] );
+                    putvarint( w , net->wiring[i].src_index[j][0] );
+                    break;
+            }
+        }
+    }
+    const neuron_s *last= NULL;
+    size_t run= 0;
+    for( layer_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
+        if( last && net->nn[i][j].fn != last->fn ){
+            putvarint( w , run );
+            put8( w , last->fn );
+            run= 0;
+        }
+        last= &net->nn[i][j];
+        run++;
+    }
+    putvarint( w , run );
+    put8( w , last ? last->fn : 0 );
+    for( unsigned plane= 0 ; plane < sizeof( float ) ; plane++ ) for( layer_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) putplane( w , &net->nn[i][j].b , 1 , plane );
+    for( unsigned plane= 0 ; plane < sizeof( float ) ; plane++ ) for( layer_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) putplane( w , net->nn[i][j].w , net->nn[i][j].inputs , plane );
+}
+
+/**
+ * @details
+ * Builds a complete version 2 file in memory: measures the payload,
+ * writes it, then packs it behind the header. Returns the file, to be
+ * released with `free()`, and its size in `*size`; NULL if memory ran
+ * out.
+ */
+static unsigned char *packnet( const net_s *net , size_t *size ){
+    ntwriter_s w= { .little_endian= checkendian( ) , .ieee754= isieee754( ) };
+    writepacked( &w , net );
+    const size_t payload= w.total;
+    w= (ntwriter_s){ .buf= malloc( payload + 1 ) , .capacity= payload , .little_endian= w.little_endian , .ieee754= w.ieee754 };
+    unsigned char *file= malloc( PACKED_HEADER + ntpackbound( payload ) );
+    if( !w.buf || !file ){
+        free( w.buf );
+        free( file );
+        return NULL;
+    }
+    writepacked( &w , net );
+    const size_t packed= ntpack( w.buf , payload , file + PACKED_HEADER , ntpackbound( payload ) );
+    free( w.buf );
+    ntwriter_s header= { .buf= file , .capacity= PACKED_HEADER , .little_endian= w.little_endian };
+    putbytes( &header , MAGIC , sizeof( MAGIC ) - 1 );
+    put8( &header , VERSION_PACKED );
+    put64( &header , payload );
+    put64( &header , packed );
+    *size= PACKED_HEADER + packed;
+    return file;
+}
+
+/**
+ * @retval 0
+ *  - `net` or `write` is NULL.
+ *  - memory for the compressed file could not be allocated.
+ *  - `write` accepted fewer bytes than it was given.
+ *
+ * @details
+ * Compresses the network as a version 2 file (see writepacked()), in memory, then hands it to `write` in one call. Any
+ * loader reads it back.
+ */
+size_t savenet_packed_stream( net_s *net , ntwrite_f write , void *ctx ){
+    if( !net || !write ) return 0;
+    size_t size= 0;
+    unsigned char *file= packnet( net , &size );
+    if( !file ) return 0;
+    if( write( ctx , file , size ) != size ) size= 0;
+    free( file );
+    return size;
+}
+
+/**
+ * @retval 0 `net` is NULL, or memory for the compressed file could not be allocated.
+ *
+ * @details
+ * savenet_packed_stream() into `buffer`. As with savenet_mem(), returns the compressed size even when it exceeds
+ * `capacity`, in which case nothing is written.
+ */
+size_t savenet_packed_mem( net_s *net , void *buffer , size_t capacity ){
+    if( !net ) return 0;
+    size_t size= 0;
+    unsigned char *file= packnet( net , &size );
+    if( !file ) return 0;
+    if( buffer && size <= capacity ) memcpy( buffer , file , size );
+    free( file );
+    return size;
+}
+
+/**
+ * @retval 0
+ *  - the filename (`name` + ".ntic") could not be allocated.
+ *  - the file could not be opened, written, closed, or renamed into place.
+ *
+ * @details
+ * savenet_packed_stream() into `name` + ".ntic", replaced as savenet() does. loadnet() recognizes the compressed version
+ * by itself.
+ */
+size_t savenet_packed( net_s *net , const char *name ){
+    return savepath( net , name , savenet_packed_stream );
+}
+
+/**
+ * @details
+ * Reads the sources of 'M' array `j` of wiring transition `i`, written
+ * by putsources(). Fails the reader on a run that is empty or overruns
+ * the array.
+ */
+static void getsources( ntreader_s *r , net_s *net , uint16_t i , uint16_t j ){
+    for( uint32_t k= 0 ; k < net->wiring[i].size[j] && !r->failed ; ){
+        const uint8_t type= get8( r );
+        const uint64_t count= getvarint( r );
+        const uint8_t indexed= type == 'N' || type == 'O' || type == 'I';
+        const uint16_t layer= type == 'N' ? (uint16_t)getvarint( r ) : 0;
+        uint16_t index= indexed ? (uint16_t)getvarint( r ) : 0;
+        const uint64_t zigzag= indexed && count > 1 ? getvarint( r ) : 0;
+        const uint16_t step= (uint16_t)( zigzag & 1 ? -(int64_t)( ( zigzag + 1 ) >> 1 ) : (int64_t)( zigzag >> 1 ) );
+        if( !count || count > net->wiring[i].size[j] - k ){
+            r->failed= 1;
+            break;
+        }
+        for( uint64_t q= 0 ; q < count ; q++ , k++ , index+= step ){
+            net->wiring[i].src_type[j][k]= type;
+            net->wiring[i].src_layer[j][k]= layer;
+            net->wiring[i].src_index[j][k]= index;
+        }
+    }
+}
+
+/**
+ * @details
+ * Decodes `plane[ 0 .. 4n )`, four byte planes of `n` little-endian
+ * IEEE 754 values, into `x`.
+ */
+static void getplanes( const unsigned char *plane , size_t n , size_t first , float *x , size_t count , uint8_t ieee754 ){
+    for( size_t k= 0 ; k < count ; k++ ){
+        const size_t at= first + k;
+        const uint32_t bits= (uint32_t)plane[at] | (uint32_t)plane[n + at] << 8 | (uint32_t)plane[2 * n + at] << 16 | (uint32_t)plane[3 * n + at] << 24;
+        x[k]= floatsys( (int32_t)bits , ieee754 );
+    }
+}
+
+/**
+ * @details
+ * Deserializes a version 2 payload, written by writepacked(), from the
+ * in-memory reader `r`. Returns a loadnet() error code.
+ */
+static size_t readpacked( net_s *net , ntreader_s *r ){
+    net->inputs= (input_t)getvarint( r );
+    const uint64_t layers= getvarint( r );
+    if( r->failed || !layers || layers > UINT16_MAX || !fits( r , net->inputs , sizeof( float ) ) ) return 5;
+    net->layers= (layer_t)layers;
+    uint16_t *neurons= calloc( (size_t)net->layers , sizeof( uint16_t ) );
+    if( !neurons ) return 4;
+    for( uint16_t i= 0 ; i < net->layers ; i++ ) neurons[i]= (uint16_t)getvarint( r );
+    const uint8_t built= !r->failed && newnet( net , neurons , net->layers );
+    free( neurons );
+    if( r->failed ) return 5;
+    if( !built ) return 4;
+    for( uint16_t i= 0 ; i < net->layers && !r->failed ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] && !r->failed ; ){
+        const uint64_t count= getvarint( r );
+        const input_t inputs= (input_t)getvarint( r );
+        const index_t bff_idx= get8( r );
+        if( !count || count > (uint64_t)( net->neurons[i] - j ) ) return 5;
+        for( uint64_t q= 0 ; q < count ; q++ , j++ ){
+            net->nn[i][j].inputs= inputs;
+            net->nn[i][j].bff_idx= bff_idx;
+        }
+    }
+    if( net->layers > 1 ) for( uint16_t i= 0 ; i < net->layers - 1 && !r->failed ; i++ ){
+        net->wiring[i].arrays= get8( r );
+        if( !wiringarrays( net , i ) ) return 4;
+        for( uint16_t j= 0 ; j < net->wiring[i].arrays && !r->failed ; j++ ){
+            net->wiring[i].array_type[j]= get8( r );
+            switch( net->wiring[i].array_type[j] ){
+                case 'M':
+                    net->wiring[i].size[j]= (uint32_t)getvarint( r );
+                    if( r->failed ) break;
+                    if( !fits( r , net->wiring[i].size[j] , sizeof( float ) ) ) return 5;
+                    if( !wiringsources( net , i , j , net->wiring[i].size[j] ) ) return 4;
+                    getsources( r , net , i , j );
+                    break;
+                case 'N':
+                    if( !wiringsources( net , i , j , 1 ) ) return 4;
+                    net->wiring[i].src_layer[j][0]= (uint16_t)getvarint( r );
+                    net->wiring[i].src_index[j][0]= (uint16_t)getvarint( r );
+                    break;
+            }
+        }
+    }
+    size_t count= 0, weights= 0;
+    index_t fn= 0;
+    for( uint16_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] && !r->failed ; j++ ){
+        if( !count ){
+            count= (size_t)getvarint( r );
+            fn= get8( r );
+            if( !count || fn >= NTACT_TOTAL_FUNCTIONS ) return 5;
+        }
+        net->nn[i][j].fn= fn;
+        count--;
     }
+    if( r->failed || count || !checknet( net ) ) return 5;
+    buildnet( net );
+    size_t neurons_total= 0;
+    for( uint16_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ , neurons_total++ ) weights+= net->nn[i][j].inputs;
+    if( unbuilt( net ) ) return 4;
+    const unsigned char *plane= r->buf + r->at;
+    if( !getbytes( r , NULL , sizeof( float ) * neurons_total ) ) return 5;
+    size_t at= 0;
+    for( uint16_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) getplanes( plane , neurons_total , at++ , &net->nn[i][j].b , 1 , r->ieee754 );
+    plane= r->buf + r->at;
+    if( !getbytes( r , NULL , sizeof( float ) * weights ) ) return 5;
+    at= 0;
     for( uint16_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
-        fread( &net->nn[i][j].inputs , sizeof( uint32_t ) , 1 , fp );
-        if( little_endian ) net->nn[i][j].inputs= bswap32( net->nn[i][j].inputs );
-        fread( &net->nn[i][j].bff_idx , sizeof( index_t ) , 1 , fp );
+        getplanes( plane , weights , at , net->nn[i][j].w , net->nn[i][j].inputs , r->ieee754 );
+        at+= net->nn[i][j].inputs;
+    }
+    return 0;
+}
+
+/**
+ * @details
+ * Reads the rest of a version 2 file from `r` -- its sizes and packed
+ * payload -- unpacks the payload and hands it to readpacked(). The packed
+ * bytes are used where they lie when `r` is in memory. Returns a
+ * loadnet() error code.
+ */
+static size_t readcompressed( net_s *net , ntreader_s *r ){
+    const uint64_t payload= get64( r ), packed= get64( r );
+    if( r->failed || packed > SIZE_MAX || payload > ntunpackbound( (size_t)packed ) || payload > SIZE_MAX - 1 ) return 5;
+    const unsigned char *from= NULL;
+    unsigned char *copy= NULL;
+    if( !r->source ){
+        from= r->buf + r->at;
+        if( !getbytes( r , NULL , (size_t)packed ) ) return 5;
+    }
+    else{
+        if( !( from= copy= malloc( (size_t)packed + 1 ) ) ) return 2;
+        if( !getbytes( r , copy , (size_t)packed ) ){
+            free( copy );
+            return 5;
+        }
+    }
+    unsigned char *plain= malloc( (size_t)payload + 1 );
+    size_t err_val= plain ? 0 : 2;
+    if( plain && ntunpack( from , (size_t)packed , plain , (size_t)payload ) != payload ) err_val= 5;
+    free( copy );
+    if( !err_val ){
+        ntreader_s p= { .buf= plain , .size= (size_t)payload , .swap= r->swap , .ieee754= r->ieee754 };
+        err_val= readpacked( net , &p );
+        if( !err_val && p.failed ) err_val= 5;
+    }
+    free( plain );
+    return err_val;
+}
+
+/**
+ * @details
+ * Deserializes a network from `r`, in any version. `map`, when not
+ * NULL, is a private writable mapping of `length` bytes that `r` reads
+ * from the start of: a version 1 weight block is then adopted from it in
+ * place, and `*adopted` set to tell the caller the mapping now belongs to
+ * the network. Returns a loadnet() error code.
+ */
+static size_t readnet( net_s *net , ntreader_s *r , unsigned char *map , size_t length , uint8_t *adopted ){
+    char magic[sizeof( MAGIC )];
+    r->swap= !checkendian( );
+    r->ieee754= isieee754( );
+    if( !getbytes( r , magic , sizeof( magic ) ) || strncmp( magic , MAGIC , sizeof( MAGIC ) - 1 ) || ( magic[sizeof( magic ) - 1] != VERSION && magic[sizeof( magic ) - 1] != VERSION_STREAM && magic[sizeof( magic ) - 1] != VERSION_PACKED ) ) return 3;
+    if( magic[sizeof( magic ) - 1] == VERSION_PACKED ) return readcompressed( net , r );
+    net->inputs= get32( r );
+    net->layers= get16( r );
+    if( !fits( r , net->inputs , sizeof( float ) ) ) return 5;
+    uint16_t *neurons= calloc( (size_t)net->layers + 1 , sizeof( uint16_t ) );
+    if( !neurons ) return 4;
+    for( uint16_t i= 0 ; i < net->layers ; i++ ) neurons[i]= get16( r );
+    const uint8_t built= !r->failed && newnet( net , neurons , net->layers );
+    free( neurons );
+    if( r->failed ) return 5;
+    if( !built ) return 4;
+    for( uint16_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
+        net->nn[i][j].inputs= get32( r );
+        net->nn[i][j].bff_idx= get8( r );
     }
     if( net->layers > 1 ){
-        for( uint16_t i= 0 ; i < net->layers - 1 ; i++ ){
-            fread( &net->wiring[i].arrays , sizeof( index_t ) , 1 , fp );
-            net->wiring[i].array_type= createregister( net , calloc( net->wiring[i].arrays , sizeof( uint8_t ) ) );
-            net->wiring[i].size= createregister( net , calloc( net->wiring[i].arrays , sizeof( uint32_t ) ) );
-            net->wiring[i].src_type= createregister( net , calloc( net->wiring[i].arrays , sizeof( uint8_t * ) ) );
-            net->wiring[i].src_layer= createregister( net , calloc( net->wiring[i].arrays , sizeof( uint16_t * ) ) );
-            net->wiring[i].src_index= createregister( net , calloc( net->wiring[i].arrays , sizeof( uint16_t * ) ) );
-            for( uint16_t j= 0 ; j < net->wiring[i].arrays ; j++ ){
-                fread( &net->wiring[i].array_type[j] , sizeof( uint8_t ) , 1 , fp );
+        for( uint16_t i= 0 ; i < net->layers - 1 && !r->failed ; i++ ){
+            net->wiring[i].arrays= get8( r );
+            if( !wiringarrays( net , i ) ) return 4;
+            for( uint16_t j= 0 ; j < net->wiring[i].arrays && !r->failed ; j++ ){
+                net->wiring[i].array_type[j]= get8( r );
                 switch( net->wiring[i].array_type[j] ){
                     case 'M':
-                        fread( &net->wiring[i].size[j] , sizeof( uint32_t ) , 1 , fp );
-                        if( little_endian ) net->wiring[i].size[j]= bswap32( net->wiring[i].size[j] );
-                        net->wiring[i].src_type[j]= createregister( net , calloc( net->wiring[i].size[j] , sizeof( uint8_t ) ) );
-                        net->wiring[i].src_layer[j]= createregister( net , calloc( net->wiring[i].size[j] , sizeof( uint16_t ) ) );
-                        net->wiring[i].src_index[j]= createregister( net , calloc( net->wiring[i].size[j] , sizeof( uint16_t ) ) );
-                        for( uint32_t k= 0 ; k < net->wiring[i].size[j] ; k++ ){
-                            fread( &net->wiring[i].src_type[j][k] , sizeof( uint8_t ) , 1 , fp );
+                        net->wiring[i].size[j]= get32( r );
+                        if( r->failed ) break;
+                        if( !fits( r , net->wiring[i].size[j] , 1 ) ) return 5;
+                        if( !wiringsources( net , i , j , net->wiring[i].size[j] ) ) return 4;
+                        for( uint32_t k= 0 ; k < net->wiring[i].size[j] && !r->failed ; k++ ){
+                            net->wiring[i].src_type[j][k]= get8( r );
                             switch( net->wiring[i].src_type[j][k] ){
                                 case 'N':
-                                    fread( &net->wiring[i].src_layer[j][k] , sizeof( uint16_t ) , 1 , fp );
-                                    if( little_endian ) net->wiring[i].src_layer[j][k]= bswap16( net->wiring[i].src_layer[j][k] );
-                                    fread( &net->wiring[i].src_index[j][k] , sizeof( uint16_t ) , 1 , fp );
-                                    if( little_endian ) net->wiring[i].src_index[j][k]= bswap16( net->wiring[i].src_index[j][k] );
+                                    net->wiring[i].src_layer[j][k]= get16( r );
+                                    net->wiring[i].src_index[j][k]= get16( r );
                                     break;
                                 case 'O':
                                 case 'I':
-                                    fread( &net->wiring[i].src_index[j][k] , sizeof( uint16_t ) , 1 , fp );
-                                    if( little_endian ) net->wiring[i].src_index[j][k]= bswap16( net->wiring[i].src_index[j][k] );
+                                    net->wiring[i].src_index[j][k]= get16( r );
                             }
                         }
                         break;
                     case 'N':
-                        net->wiring[i].src_type[j]= createregister( net , calloc( sizeof( uint8_t ) , 1 ) );
-                        net->wiring[i].src_layer[j]= createregister( net , calloc( sizeof( uint16_t ) , 1 ) );
-                        net->wiring[i].src_index[j]= createregister( net , calloc( sizeof( uint16_t ) , 1 ) );
-                        fread( &net->wiring[i].src_layer[j][0] , sizeof( uint16_t ) , 1 , fp );
-                        if( little_endian ) net->wiring[i].src_layer[j][0]= bswap16( net->wiring[i].src_layer[j][0] );
-                        fread( &net->wiring[i].src_index[j][0] , sizeof( uint16_t ) , 1 , fp );
-                        if( little_endian ) net->wiring[i].src_index[j][0]= bswap16( net->wiring[i].src_index[j][0] );
+                        if( !wiringsources( net , i , j , 1 ) ) return 4;
+                        net->wiring[i].src_layer[j][0]= get16( r );
+                        net->wiring[i].src_index[j][0]= get16( r );
                         break;
                 }
             }
         }
     }
-    buildnet( net );
+    if( r->failed || !checknet( net ) ) return 5;
+    if( magic[sizeof( magic ) - 1] == VERSION_STREAM ){
+        buildnet( net );
+        if( unbuilt( net ) ) return 4;
+        for( uint16_t i= 0 ; i < net->layers && !r->failed ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] && !r->failed ; j++ ){
+            net->nn[i][j].fn= get8( r );
+            net->nn[i][j].b= floatsys( (int32_t)get32( r ) , r->ieee754 );
+            getfloats( r , net->nn[i][j].w , net->nn[i][j].inputs );
+            r->failed|= net->nn[i][j].fn >= NTACT_TOTAL_FUNCTIONS;
+        }
+        return r->failed ? 5 : 0;
+    }
     for( uint16_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ){
-        fread( &net->nn[i][j].fn , sizeof( uint8_t ) , 1 , fp );
-        uint32_t aux;
-        fread( &aux , sizeof( uint32_t ) , 1 , fp );
-        if( little_endian ) aux= bswap32( aux );
-        net->nn[i][j].b= floatsys( aux , ieee754 );
-        for( uint32_t k= 0 ; k < net->nn[i][j].inputs ; k++ ){
-            fread( &aux , sizeof( uint32_t ) , 1 , fp );
-            if( little_endian ) aux= bswap32( aux );
-            net->nn[i][j].w[k]= floatsys( aux , ieee754 );
+        net->nn[i][j].fn= get8( r );
+        net->nn[i][j].b= floatsys( (int32_t)get32( r ) , r->ieee754 );
+        r->failed|= net->nn[i][j].fn >= NTACT_TOTAL_FUNCTIONS;
+    }
+    const uint64_t offset= get64( r ), weights= get64( r ), at= r->offset + r->at;
+    if( r->failed || offset < at || offset - at < SHARED_HEADER ) return 5;
+    if( map && !r->swap && r->ieee754 && weights && offset <= length && length - offset >= weights ){
+        weight_t *w= createsharedmap( net , map , length , offset );
+        if( w ){
+            *adopted= 1;
+            getbytes( r , NULL , offset - at + weights );
+            if( buildshared( net , w , weights ) ) return 0;
+            deleteblock( net , w );
+            return 5;
         }
     }
-    EXIT:
-    if( neurons ) free( neurons );
-    if( fp ) fclose( fp );
+    buildnet( net );
+    if( unbuilt( net ) ) return 4;
+    uint64_t rows= 0;
+    for( uint16_t i= 0 ; i < net->layers ; i ++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) rows+= ARENA_SIZE( net->nn[i][j].inputs * sizeof( weight_t ) );
+    if( rows != weights ) return 5;
+    getbytes( r , NULL , offset - at );
+    if( weights ) getfloats( r , net->nn[0][0].w , weights / sizeof( weight_t ) );
+    return r->failed ? 5 : 0;
+}
+
+/**
+ * @retval 2 the staging buffer could not be allocated.
+ * @retval 3 the input's magic string or version byte does not match what this module reads.
+ * @retval 4 the network's base structure could not be built from the input's header data.
+ * @retval 5 the input ends early, references a neuron, buffer, input, output or activation that does not exist, or its
+ *           weight block does not match the network's rows.
+ *
+ * @details
+ * Reconstructs the network structure, weights, biases, and buffer wiring from bytes pulled through `read`, in blocks of
+ * @ref STREAM_BLOCK bytes; large runs, such as a version 1 weight block, are read straight into place. Conversion from
+ * little-endian IEEE 754 works on whole rows, and on a host that already matches, none is needed.
+ *
+ * @warning
+ * `read` may be asked for more bytes than the network occupies: input following it can be consumed.
+ */
+size_t loadnet_stream( net_s *net , ntread_f read , void *ctx ){
+    ntreader_s r= { .source= read , .ctx= ctx , .block= malloc( STREAM_BLOCK ) };
+    if( !r.block ) return 2;
+    r.buf= r.block;
+    const size_t err_val= readnet( net , &r , NULL , 0 , NULL );
+    free( r.block );
+    return err_val;
+}
+
+/**
+ * @retval 3 `buffer` does not hold a network in either version.
+ * @retval 4 the network's base structure could not be built from the buffer's header data.
+ * @retval 5 the buffer ends early, references a neuron, buffer, input, output or activation that does not exist, or its
+ *           weight block does not match the network's rows.
+ *
+ * @details
+ * Reconstructs the network from the `size` bytes at `buffer`, as saved by savenet_mem() or read from any `.ntic` file. The
+ * weights are copied into memory of the network's own, so `buffer` can be released afterwards.
+ */
+size_t loadnet_mem( net_s *net , const void *buffer , size_t size ){
+    ntreader_s r= { .buf= buffer , .size= buffer ? size : 0 };
+    return readnet( net , &r , NULL , 0 , NULL );
+}
+
+/**
+ * @details
+ * ntread_f over a `FILE *`.
+ */
+static size_t readfile( void *ctx , void *data , size_t size ){
+    return fread( data , 1 , size , ctx );
+}
+
+/**
+ * @retval 2 `fp` is NULL, or the staging buffer could not be allocated.
+ *
+ * @details
+ * loadnet_stream() from `fp`, from its current position. When the stream is seekable, it is left right after the network.
+ * Other codes as loadnet_stream().
+ */
+size_t loadnet_file( net_s *net , FILE *fp ){
+    if( !fp ) return 2;
+    ntreader_s r= { .source= readfile , .ctx= fp , .block= malloc( STREAM_BLOCK ) };
+    if( !r.block ) return 2;
+    r.buf= r.block;
+    const size_t err_val= readnet( net , &r , NULL , 0 , NULL );
+    if( r.size > r.at ) fseek( fp , -(long)( r.size - r.at ) , SEEK_CUR );
+    free( r.block );
+    return err_val;
+}
+
+/**
+ * @details
+ * ntread_f over a file descriptor, retrying interrupted reads.
+ */
+static size_t readfd( void *ctx , void *data , size_t size ){
+    const int fd= *(const int *)ctx;
+    ssize_t n;
+    while( ( n= read( fd , data , size ) ) < 0 && errno == EINTR );
+    return n > 0 ? (size_t)n : 0;
+}
+
+/**
+ * @retval 2 the staging buffer could not be allocated.
+ *
+ * @details
+ * Loads the network from the file descriptor `fd`, from its current position, and leaves `fd` right after it when it is
+ * seekable. Other codes as loadnet_stream().
+ *
+ * A regular file read from its start is mapped privately instead of read: a version 1 weight block is then used where it
+ * lies, on a little-endian IEEE 754 host, as the network's shared weight block (see createsharedmap() and buildshared()).
+ * Nothing is copied; pages are read on first use and stay shared with every other process mapping the same file until
+ * written to. Everything else is read through loadnet_stream()'s staging buffer.
+ */
+size_t loadnet_fd( net_s *net , int fd ){
+    struct stat st;
+    if( !fstat( fd , &st ) && S_ISREG( st.st_mode ) && st.st_size > 0 && lseek( fd , 0 , SEEK_CUR ) == 0 ){
+        unsigned char *map= mmap( NULL , (size_t)st.st_size , PROT_READ | PROT_WRITE , MAP_PRIVATE , fd , 0 );
+        if( map != MAP_FAILED ){
+            ntreader_s r= { .buf= map , .size= (size_t)st.st_size };
+            uint8_t adopted= 0;
+            const size_t err_val= readnet( net , &r , map , (size_t)st.st_size , &adopted );
+            if( !adopted ) munmap( map , (size_t)st.st_size );
+            lseek( fd , (off_t)r.at , SEEK_SET );
+            return err_val;
+        }
+    }
+    ntreader_s r= { .source= readfd , .ctx= &fd , .block= malloc( STREAM_BLOCK ) };
+    if( !r.block ) return 2;
+    r.buf= r.block;
+    const size_t err_val= readnet( net , &r , NULL , 0 , NULL );
+    if( r.size > r.at ) lseek( fd , -(off_t)( r.size - r.at ) , SEEK_CUR );
+    free( r.block );
+    return err_val;
+}
+
+/**
+ * @retval 1 the filename (`name` + ".ntic") could not be allocated.
+ * @retval 2 the file could not be opened for reading.
+ * @retval 3 the file's magic string or version byte does not match what this module reads.
+ * @retval 4 the network's base structure could not be built from the file's header data.
+ * @retval 5 the file ends early, references a neuron, buffer, input, output or activation that does not exist, or its
+ *           weight block does not match the network's rows.
+ *
+ * @details
+ * loadnet_fd() over `name` + ".ntic", so a version 1 file is mapped and its weights used in place where the host allows it.
+ * The filename has no length limit of its own.
+ *
+ * @warning A network whose weights were mapped reads them from the file for as long as it lives. savenet() and
+ * savenet_packed() replace a file by renaming a new one over it, which leaves the mapping intact, but truncating or
+ * rewriting the file in place by any other means while such a network exists is unsafe: its weights change under it, and
+ * pages past the new end of the file fault with SIGBUS.
+ * 
+ * @todo Implement data standardization during loading, such as rejecting non-finite weights and biases.
+ */
+size_t loadnet( net_s *net , const char *name ){
+    char *path= malloc( strlen( name ) + sizeof( ".ntic" ) );
+    if( !path ) return 1;
+    strcat( strcpy( path , name ) , ".ntic" );
+    const int fd= open( path , O_RDONLY );
+    free( path );
+    if( fd < 0 ) return 2;
+    const size_t err_val= loadnet_fd( net , fd );
+    close( fd );
     return err_val;
 }
-#pragma GCC diagnostic pop
\ No newline at end of file
@@ -2,8 +2,9 @@
  * @file ntinitialize.c
  * @brief Implementation Random Initialization.
  *
- * Initializes all neuron weights within their activation function's specified range and sets biases to zero.  
- * Uses `rand()` seeded with the current time.
+ * Initializes all neuron weights from an explicitly seeded generator and sets biases to zero.  
+ * Weights are drawn either within their activation function's specified range, or scaled to each
+ * neuron's fan-in (Xavier/He), so signals keep their scale from layer to layer.
  * 
  * @author Oscar Sotomayor
  * @date 2026
@@ -12,21 +13,102 @@
 #include "ntinitialize.h"
 
 #include "ntactivation.h"
-#include <stdlib.h>
+#include "ntbuilder.h"
+#include "ntrandom.h"
+#include "ntthread.h"
+#include <math.h>
+#include <stdatomic.h>
 #include <time.h>
 
+/** Weights above which initialization is spread across threads. */
+#define PARALLEL_WEIGHTS ( 1u << 16 )
 
 /**
  * @details
- * Iterates through every neuron in the network, assigning each of its
- * weights a value drawn from `rand()` and linearly scaled into the range
- * defined for that neuron's activation function in `ntact_rand_range`.
- * Biases are set to zero for all neurons.
+ * Shared state of one initnet() call.
  */
-void randnet( net_s *net ){
-    srand( time( NULL ) );
-    for( uint16_t i= 0, j ; i < net->layers ; i++ ) for( j= 0 ; j < net->neurons[i] ; j++ ){
-        for( uint32_t k= 0 ; k < net->nn[i][j].inputs ; k++ ) net->nn[i][j].w[k]= ( ( float )rand( ) / RAND_MAX ) * ( ntact_rand_range[net->nn[i][j].fn][1] - ntact_rand_range[net->nn[i][j].fn][0] ) + ntact_rand_range[net->nn[i][j].fn][0];
-        net->nn[i][j].b = 0.0f;
+typedef struct initjob_s {
+    net_s           *net;
+    uint64_t        seed;
+    ntinit_mode_t   mode;
+} initjob_s;
+
+/**
+ * @details
+ * Initializes neuron `j` of layer `i`. Its weights come from a stream of
+ * its own, seeded from the call's seed and the neuron's flat index
+ * `flat`, so the result does not depend on how neurons are split across
+ * threads. Fan-out is taken as the next layer's width (the neuron's own
+ * fan-in on the output layer).
+ */
+static void initneuron( const initjob_s *job , layer_t i , uint16_t j , uint64_t flat ){
+    net_s *net= job->net;
+    neuron_s *neuron= &net->nn[i][j];
+    ntinit_mode_t mode= job->mode;
+    ntrand_s rng;
+    ntseed( &rng , ntmix( job->seed ^ ntmix( flat ) ) );
+    if( mode == NTINIT_AUTO ) mode= neuron->fn == NTACT_RELU || neuron->fn == NTACT_LRELU ? NTINIT_HE : NTINIT_XAVIER;
+    const float fan_in= neuron->inputs ? (float)neuron->inputs : 1.0f;
+    const float fan_out= i + 1 < net->layers ? (float)net->neurons[i + 1] : fan_in;
+    float low= ntact_rand_range[neuron->fn][0], span= ntact_rand_range[neuron->fn][1] - low;
+    if( mode == NTINIT_XAVIER ){
+        span= 2.0f * sqrtf( 6.0f / ( fan_in + fan_out ) );
+        low= -0.5f * span;
+    }
+    if( mode == NTINIT_HE ){
+        const float deviation= sqrtf( 2.0f / fan_in );
+        for( input_t k= 0 ; k < neuron->inputs ; k++ ) neuron->w[k]= ntrandnormal( &rng ) * deviation;
+    }
+    else for( input_t k= 0 ; k < neuron->inputs ; k++ ) neuron->w[k]= ntrandfloat( &rng ) * span + low;
+    neuron->b= 0.0f;
+}
+
+/**
+ * @details
+ * ntparallel() callback: initializes the neurons whose flat indices lie in
+ * `[begin, end)`.
+ */
+static void initrange( void *ctx , size_t begin , size_t end , unsigned worker ){
+    const initjob_s *job= ctx;
+    size_t first= 0;
+    (void)worker;
+    for( layer_t i= 0 ; i < job->net->layers && first < end ; first+= job->net->neurons[i++] ){
+        for( size_t n= begin > first ? begin : first ; n < end && n < first + job->net->neurons[i] ; n++ ) initneuron( job , i , (uint16_t)( n - first ) , n );
     }
 }
+
+/**
+ * @details
+ * Every neuron draws from an independent xoshiro256** stream derived from
+ * `seed` and its position, so results are reproducible whatever the
+ * number of threads. The modes scale weights as follows:
+ * - `NTINIT_RANGE`: uniform in `ntact_rand_range` of the neuron's
+ *   activation.
+ * - `NTINIT_XAVIER`: uniform in `±sqrt( 6 / ( fan_in + fan_out ) )`.
+ * - `NTINIT_HE`: normal with deviation `sqrt( 2 / fan_in )`.
+ * - `NTINIT_AUTO`: He for ReLU and leaky ReLU neurons, Xavier otherwise.
+ *
+ * Networks with more than `PARALLEL_WEIGHTS` weights are initialized
+ * across every available thread. Biases are set to zero for all neurons.
+ * Weights still shared with a clone are copied first (see ownweights()),
+ * and nothing is initialized if the copy cannot be made.
+ */
+void initnet( net_s *net , uint64_t seed , ntinit_mode_t mode ){
+    if( !ownweights( net ) ) return;
+    initjob_s job= { .net= net , .seed= seed , .mode= mode < NTINIT_TOTAL_MODES ? mode : NTINIT_AUTO };
+    size_t neurons= 0, weights= 0;
+    for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ , neurons++ ) weights+= net->nn[i][j].inputs;
+    ntparallel( neurons , weights > PARALLEL_WEIGHTS ? 0 : 1 , initrange , &job );
+}
+
+/**
+ * @details
+ * Initializes weights within each activation's `ntact_rand_range`, as
+ * initnet() with `NTINIT_RANGE`. The seed mixes the current time with a
+ * per-process call counter, so networks initialized within the same
+ * second still get different weights. Use initnet() for reproducible runs.
+ */
+void randnet( net_s *net ){
+    static _Atomic uint64_t calls= 0;
+    initnet( net , ntmix( (uint64_t)time( NULL ) ) ^ ntmix( ++calls ) , NTINIT_RANGE );
+}
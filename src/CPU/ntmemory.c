@@ -3,17 +3,86 @@
  * @brief Implementation of memory management functions.
  * 
  * Provides functions for tracking dynamically allocated memory blocks and ensuring they are freed at program termination.  
- * Uses a dynamic registry to store pointers to allocated memory, and registers a cleanup function with `atexit()` to automatically free all tracked memory when the program exits.
+ * Owners may also be given a placement, so their arena slabs are mapped on huge pages and bound to a NUMA node.  
+ * Keeps allocated pointers in hash tables keyed by owner and by block, which grow geometrically so building a network with many blocks stays linear, and registers a cleanup function with `atexit()` to automatically free all tracked memory when the program exits.  
+ * The registry is split into independently locked shards keyed by owner, and blocks are allocated and freed outside any lock, so threads building, loading or deleting different networks proceed in parallel.
  * 
  * @author Oscar Sotomayor
  * @date 2026
  */
 
+#define _GNU_SOURCE
+
 #include "ntmemory.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <search.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/** Number of independent registry shards; a power of two. */
+#define MEM_SHARDS 16
+
+/** Initial slot count of a shard's owner table and of every owner's register; always a power of two. */
+#define MEM_SLOTS 16
+
+/** Alignment of every arena slab: one cache line, so the first block of a slab never straddles two. */
+#define SLAB_ALIGN 64
+
+/** Size of the first slab arenaalloc() chains in on its own, when no planned arena has room. */
+#define ARENA_CHUNK 4096
+
+/** Cap on the doubling of unplanned slabs. */
+#define ARENA_CHUNK_MAX ( 1 << 20 )
+
+/** Huge page size slabs are aligned to when a placement asks for huge pages. */
+#define HUGE_PAGE ( (size_t)2 << 20 )
+
+/** Number of NUMA nodes the `mbind` node mask can express. */
+#define NODE_LIMIT 1024
+
+/** `MPOL_BIND` from the kernel's memory policy API, spelled out so no NUMA headers are needed. */
+#define POLICY_BIND 2
+
+/**
+ * @details
+ * How a registered block goes back to the system.
+ */
+typedef enum {
+    NTMEM_HEAP,     ///< `free()`
+    NTMEM_MAPPED,   ///< `munmap()` over its registered size
+    NTMEM_SHARED,   ///< Drop one reference; the last one releases the slab
+
+    NTMEM_TOTAL_KINDS ///< Total number of block kinds
+} ntmem_kind_t;
+
+/**
+ * @details
+ * Header of a shared block, kept in the @ref SHARED_HEADER bytes right
+ * before it: at the start of its slab, or inside an adopted mapping (see
+ * createsharedmap()).
+ */
+struct mem_share{
+    atomic_size_t refs;     /**< Owners currently holding the block. */
+    void    *base;          /**< Start of the slab or mapping the block lives in. */
+    size_t  length;         /**< Length of that slab or mapping. */
+    size_t  size;           /**< Usable size of the block, as accounted. */
+    ntmem_kind_t kind;      /**< How the slab itself is released: heap or mapped. */
+};
+
+/**
+ * @details
+ * One slot of an owner's register.
+ */
+struct mem_block{
+    void    *mem;           /**< The block; NULL marks an empty slot. */
+    size_t  size;           /**< Declared size in bytes; the mapping length for a mapped block. */
+    ntmem_kind_t kind;      /**< How the block is released. */
+};
 
 /**
  * @details
@@ -21,65 +90,255 @@
  * the owner that requested them (typically a net_s instance), so every
  * block belonging to that owner can be located and freed together.
  *
- * `mem_tracker` is the array of every currently tracked owner -- `NULL`
- * exactly when the global @ref mem_track "mem_track" count is zero.
+ * Each `mem_register` is an open-addressed set of blocks, probed linearly
+ * from the hash of the block's address; a slot whose address is NULL is
+ * empty. Finding a
+ * block costs O(1) on average and the set doubles in size, never grows
+ * by one.
  */
 struct mem_format{
     void    *mem_owner;     /**< Pointer to the owner of the memory block. */
-    void    **mem_register; /**< Internal registry for tracking allocated memory blocks. */
+    struct mem_block *mem_register; /**< Hash set of the blocks registered under `mem_owner`. */
     size_t  mem_track;      /**< Counter for the number of tracked memory blocks. */
-} *mem_tracker= NULL;
+    size_t  mem_slots;      /**< Slot count of `mem_register`, a power of two (0 while it is unallocated). */
+    unsigned char *mem_arena; /**< Next free byte of the owner's current arena slab, NULL if it has none. */
+    size_t  mem_free;       /**< Bytes still available after `mem_arena`. */
+    size_t  mem_chunk;      /**< Size of the next unplanned slab, 0 until the first one. */
+    size_t  mem_bytes;      /**< Sum of the registered blocks' sizes. */
+    size_t  mem_shared;     /**< Of `mem_bytes`, the sizes of shared blocks, which other owners may hold too. */
+    size_t  mem_peak;       /**< Highest `mem_bytes` ever reached. */
+    placement_s mem_place;  /**< Where new arena slabs go, when `mem_placed` is set. */
+    unsigned char mem_placed; /**< Nonzero once placeowner() gave the owner a placement. */
+};
+
+/**
+ * @details
+ * One independent slice of the registry. Every owner lives in exactly
+ * one shard, chosen from the top bits of its hash, so each operation --
+ * which always concerns a single owner -- takes a single shard's lock
+ * and threads building or freeing different networks rarely meet.
+ *
+ * `mem_tracker` is an open-addressed hash table of the shard's owners,
+ * probed linearly from the low bits of the same hash; a slot whose
+ * `mem_owner` is NULL is empty. It is `NULL` exactly when `mem_track` is
+ * zero.
+ */
+struct mem_shard{
+    struct mem_format *mem_tracker; /**< Owner table of this shard. */
+    size_t  mem_track;      /**< Number of owners tracked in this shard. */
+    size_t  mem_slots;      /**< Slot count of `mem_tracker`, a power of two (0 while it is unallocated). */
+    atomic_uchar mem_lock;  /**< Nonzero while a thread holds the shard. */
+};
+
+/**
+ * @details
+ * The registry. Static zero initialization leaves every shard empty and
+ * unlocked.
+ */
+static struct mem_shard mem_shards[MEM_SHARDS];
 
+/**
+ * @details
+ * Set by the first owner ever tracked so `atexit( cleanmemory )` is
+ * registered exactly once, even when the first owners are created
+ * concurrently. Checked with a plain load first, so later calls never
+ * write to the shared cache line.
+ */
+static atomic_bool mem_exit= 0;
+
+/**
+ * @details
+ * Bytes currently registered across every owner, and the highest value
+ * it has ever reached. Kept outside the shards so memoryusage() can
+ * report a peak without the registry keeping any history. A shared
+ * block counts once however many owners hold it, in `mem_total` and in
+ * `mem_shared_total`: from its creation until its last holder releases
+ * it.
+ */
+static atomic_size_t mem_total= 0, mem_peak= 0, mem_shared_total= 0;
+
+/**
+ * @details
+ * Adds `size` bytes to the registry total, raising the peak if needed.
+ */
+static void addtotal( size_t size ){
+    size_t total= atomic_fetch_add_explicit( &mem_total , size , memory_order_relaxed ) + size;
+    size_t peak= atomic_load_explicit( &mem_peak , memory_order_relaxed );
+    while( peak < total && !atomic_compare_exchange_weak_explicit( &mem_peak , &peak , total , memory_order_relaxed , memory_order_relaxed ) );
+}
+
+/**
+ * @details
+ * Accounts a new shared block of `size` bytes, once, on behalf of every
+ * owner that will hold it.
+ */
+static void addshared( size_t size ){
+    atomic_fetch_add_explicit( &mem_shared_total , size , memory_order_relaxed );
+    addtotal( size );
+}
+
+/**
+ * @details
+ * Scrambles a pointer value into a 64-bit hash. Allocators return
+ * aligned addresses a fixed stride apart, so the low bits alone would
+ * pile every block into the same few slots; the finalizer spreads them
+ * across every bit, the low ones indexing tables and the top ones picking
+ * the shard.
+ */
+static uint64_t hashpointer( const void *key ){
+    uint64_t x= (uint64_t)(uintptr_t)key;
+    x^= x >> 33;
+    x*= 0xff51afd7ed558ccdULL;
+    x^= x >> 33;
+    x*= 0xc4ceb9fe1a85ec53ULL;
+    x^= x >> 33;
+    return x;
+}
+
+/**
+ * @details
+ * Returns the shard `owner` belongs to.
+ */
+static struct mem_shard *shardof( const void *owner ){
+    return &mem_shards[hashpointer( owner ) >> 60 & (MEM_SHARDS - 1)];
+}
+
+/**
+ * @details
+ * Acquires `shard`. Critical sections are a hash probe or an occasional
+ * rehash -- allocation and freeing of blocks happen outside -- so a
+ * waiting thread spins on a plain load and yields its core between
+ * attempts rather than sleeping.
+ */
+static void lockshard( struct mem_shard *shard ){
+    while( atomic_exchange_explicit( &shard->mem_lock , 1 , memory_order_acquire ) ) while( atomic_load_explicit( &shard->mem_lock , memory_order_relaxed ) ) sched_yield( );
+}
+
+/**
+ * @details
+ * Releases `shard`.
+ */
+static void unlockshard( struct mem_shard *shard ){
+    atomic_store_explicit( &shard->mem_lock , 0 , memory_order_release );
+}
 
 /**
+ * @return Index of the slot holding `owner`, or of the empty slot where
+ *         it would be inserted.
+ *
  * @details
- * The number of currently tracked owners -- not to be confused with the
- * per-owner `mem_format::mem_track` field, which counts memory blocks
- * registered under a single owner. Increases by one each time
- * createowner() tracks a new owner; decreases by one each time
- * deleteowner() removes one.
+ * Linear probe of the shard's owner table; requires the table to be
+ * allocated and never full.
  */
-size_t mem_track= 0;
+static size_t ownerslot( const struct mem_shard *shard , const void *owner ){
+    size_t i= (size_t)hashpointer( owner ) & (shard->mem_slots - 1);
+    while( shard->mem_tracker[i].mem_owner && shard->mem_tracker[i].mem_owner != owner ) i= (i + 1) & (shard->mem_slots - 1);
+    return i;
+}
 
+/**
+ * @return Index of the slot holding `mem` in `set`, or of the empty slot
+ *         where it would be inserted.
+ *
+ * @details
+ * Linear probe of one owner's register; requires `slots` to be a power
+ * of two and the set never full.
+ */
+static size_t blockslot( const struct mem_block *set , size_t slots , const void *mem ){
+    size_t i= (size_t)hashpointer( mem ) & (slots - 1);
+    while( set[i].mem && set[i].mem != mem ) i= (i + 1) & (slots - 1);
+    return i;
+}
 
 /**
- * @param key Pointer to the memory owner to match.
- * @param element Pointer to the mem_format element being compared.
- * @retval 0 `*key` equals `element`'s `mem_owner` (match found).
- * @retval 1 `*key` differs from `element`'s `mem_owner` -- this includes
- *           the case where either (or both) is NULL, since NULL is
- *           treated as an ordinary pointer value here.
+ * @retval 0 The owner table has room for one more owner.
+ * @retval 1 It had to grow and the allocation failed; nothing changed.
  *
  * @details
- * Comparison callback for `lfind()`, used to locate a specific owner
- * within the `mem_tracker` array. Compares `*key` against the `mem_owner`
- * field of each element via plain pointer equality.
+ * Doubles the shard's owner table (allocating it at @ref MEM_SLOTS slots
+ * the first time) once one more owner would push it past half full,
+ * reinserting every tracked owner at its new position.
  */
-int match_owner( const void *key , const void *element){
-    return *(void **)key != ((struct mem_format *)element)->mem_owner;
+static unsigned char growowners( struct mem_shard *shard ){
+    if( 2 * (shard->mem_track + 1) <= shard->mem_slots ) return 0;
+    size_t old_slots= shard->mem_slots;
+    struct mem_format *old= shard->mem_tracker;
+    size_t slots= old_slots ? 2 * old_slots : MEM_SLOTS;
+    struct mem_format *tmp= calloc( slots , sizeof( struct mem_format ) );
+    if( !tmp ) return 1;
+    shard->mem_tracker= tmp;
+    shard->mem_slots= slots;
+    for( size_t i= 0 ; i < old_slots ; i++ ) if( old[i].mem_owner ) shard->mem_tracker[ownerslot( shard , old[i].mem_owner )]= old[i];
+    free( old );
+    return 0;
 }
 
 /**
- * @param key Pointer to the memory block pointer to match.
- * @param element Pointer to the registered block being compared.
- * @retval 0 `*key` equals `*element` (match found).
- * @retval 1 `*key` differs from `*element`.
+ * @retval 0 The register has room for one more block.
+ * @retval 1 It had to grow and the allocation failed; nothing changed.
  *
  * @details
- * Comparison callback for `lfind()`, used to locate a specific memory
- * block within one owner's `mem_register` array. Unlike match_owner(),
- * both `key` and `element` here are treated as a single registered
- * `void *` block -- no `mem_format` element is involved.
+ * Same policy as growowners(), applied to a single owner's register.
+ */
+static unsigned char growblocks( struct mem_format *owner ){
+    if( 2 * (owner->mem_track + 1) <= owner->mem_slots ) return 0;
+    size_t slots= owner->mem_slots ? 2 * owner->mem_slots : MEM_SLOTS;
+    struct mem_block *tmp= calloc( slots , sizeof( struct mem_block ) );
+    if( !tmp ) return 1;
+    for( size_t i= 0 ; i < owner->mem_slots ; i++ ) if( owner->mem_register[i].mem ) tmp[blockslot( tmp , slots , owner->mem_register[i].mem )]= owner->mem_register[i];
+    free( owner->mem_register );
+    owner->mem_register= tmp;
+    owner->mem_slots= slots;
+    return 0;
+}
+
+/**
+ * @details
+ * Drops one reference to the shared block `mem`; the last reference
+ * releases the slab it lives in.
  */
-int match_register( const void *key , const void *element){
-    return *(void **)key != *(void **)element;
+static void releaseshared( void *mem ){
+    struct mem_share *share= (struct mem_share *)( (unsigned char *)mem - SHARED_HEADER );
+    if( atomic_fetch_sub_explicit( &share->refs , 1 , memory_order_acq_rel ) != 1 ) return;
+    atomic_fetch_sub_explicit( &mem_total , share->size , memory_order_relaxed );
+    atomic_fetch_sub_explicit( &mem_shared_total , share->size , memory_order_relaxed );
+    if( share->kind == NTMEM_MAPPED ) munmap( share->base , share->length );
+    else free( share->base );
+}
+
+/**
+ * @details
+ * Releases every block in `owner`'s register according to its kind, then
+ * the register itself. Works on an entry already detached from its
+ * shard, so no lock is held while the blocks go back to the system.
+ */
+static void freeblocks( struct mem_format *owner ){
+    if( owner->mem_register ){
+        for( size_t i= 0 ; i < owner->mem_slots ; i++ ) switch( owner->mem_register[i].kind ){
+            case NTMEM_MAPPED:
+                munmap( owner->mem_register[i].mem , owner->mem_register[i].size );
+                break;
+            case NTMEM_SHARED:
+                releaseshared( owner->mem_register[i].mem );
+                break;
+            default:
+                free( owner->mem_register[i].mem );
+                break;
+        }
+        free( owner->mem_register );
+    }
+    atomic_fetch_sub_explicit( &mem_total , owner->mem_bytes - owner->mem_shared , memory_order_relaxed );
+    memset( owner , 0 , sizeof( struct mem_format ) );
 }
 
 /**
  * @details
  * Frees every memory block registered under every tracked owner, then
- * frees each owner's register and the `mem_tracker` array itself,
- * resetting `mem_track` to zero.
+ * frees each owner's register and every shard's owner table, leaving
+ * the registry empty.
+ *
+ * Each shard is detached under its own lock and emptied after releasing
+ * it.
  *
  * @warning
  * Not meant to be called manually -- it is registered with `atexit()` (by
@@ -94,98 +353,119 @@ int match_register( const void *key , const void *element){
  * deleteowner() to remove a single owner instead of everything.
  */
 void cleanmemory( void ){
-    if( mem_tracker ){
-        while( mem_track ){
-            --mem_track;
-            if( mem_tracker[mem_track].mem_register ){
-                for( size_t i= 0 ; i < mem_tracker[mem_track].mem_track ; i++ ) if( mem_tracker[mem_track].mem_register[i] ){
-                    free( mem_tracker[mem_track].mem_register[i] );
-                    mem_tracker[mem_track].mem_register[i]= NULL;
-                }
-                memset( mem_tracker[mem_track].mem_register , 0 , mem_tracker[mem_track].mem_track * sizeof( void * ) );
-                free( mem_tracker[mem_track].mem_register );
-                mem_tracker[mem_track].mem_register= NULL;
-            }
-            if( mem_tracker[mem_track].mem_owner ) mem_tracker[mem_track].mem_owner= NULL;
-        }
-        free( mem_tracker );
-        mem_tracker= NULL;
-    } else mem_track= 0;
+    for( size_t s= 0 ; s < MEM_SHARDS ; s++ ){
+        struct mem_shard *shard= &mem_shards[s];
+        lockshard( shard );
+        struct mem_format *table= shard->mem_tracker;
+        size_t slots= shard->mem_slots;
+        shard->mem_tracker= NULL;
+        shard->mem_slots= 0;
+        shard->mem_track= 0;
+        unlockshard( shard );
+        for( size_t i= 0 ; i < slots ; i++ ) if( table[i].mem_owner ) freeblocks( &table[i] );
+        free( table );
+    }
 }
 
 /**
  * @retval 1 `owner` is NULL.
- * @retval 2 the compacted tracker array could not be allocated (only
- *           reachable when 2 or more owners are tracked).
  *
  * @details
  * Deletes `owner` and every memory block registered under it.
  *
- * When two or more owners are tracked, searches for `owner` and, if
- * found, frees its registered blocks and compacts the remaining owners
- * into a freshly allocated array.
- *
- * When at most one owner is tracked, deleting the sole remaining owner
- * (if `owner` matches it) is equivalent to clearing the entire tracking
- * system, so cleanmemory() is called directly instead of shrinking an
- * array down to zero elements.
+ * Looks `owner` up by hash in its shard and, if found, detaches its entry
+ * with backward-shift deletion: every entry in the probe run after the
+ * freed slot that could legally sit in it is moved back, so no tombstones
+ * accumulate and lookups never have to skip them. The table never has to
+ * be reallocated to shrink, so deletion cannot fail for lack of memory;
+ * the shard's last owner takes the table with it. The detached blocks
+ * are freed once the shard lock has been released.
  *
  * If `owner` is not currently tracked, nothing is deleted.
  */
 unsigned char deleteowner( void *owner ){
     if( !( owner ) ) return 1;
-    if( (mem_track - !!mem_track) && mem_tracker ){
-        struct mem_format *owner_index= (struct mem_format *)lfind( &owner , mem_tracker , &mem_track , sizeof( struct  mem_format ) , match_owner );
-        if( owner_index ){
-            if( owner_index->mem_register ){
-                for( size_t i= 0 ; i < owner_index->mem_track ; i++ ) if( owner_index->mem_register[i] ){
-                    free( owner_index->mem_register[i] );
-                    owner_index->mem_register[i]= NULL;
-                }
-                memset( owner_index->mem_register , 0 , owner_index->mem_track * sizeof( void * ) );
-                free( owner_index->mem_register );
-            }
-            struct mem_format *tmp= calloc( mem_track - 1 , sizeof( struct mem_format ) );
-            if( !tmp ) return 2;
-            else --mem_track;
-            memmove( owner_index , owner_index + (owner_index != &mem_tracker[mem_track]) , ((&mem_tracker[mem_track] - owner_index) + (owner_index == &mem_tracker[mem_track])) * sizeof( struct mem_format ) );
-            memcpy( tmp , mem_tracker , mem_track * sizeof( struct mem_format ) );
-            memset( mem_tracker , 0 , mem_track * sizeof( struct mem_format ) );
-            free( mem_tracker );
-            mem_tracker= tmp;
-            tmp= NULL;
+    struct mem_shard *shard= shardof( owner );
+    struct mem_format detached= { 0 };
+    struct mem_format *table= NULL;
+    lockshard( shard );
+    size_t hole= shard->mem_tracker ? ownerslot( shard , owner ) : 0;
+    if( shard->mem_tracker && shard->mem_tracker[hole].mem_owner ){
+        detached= shard->mem_tracker[hole];
+        memset( &shard->mem_tracker[hole] , 0 , sizeof( struct mem_format ) );
+        if( !--shard->mem_track ){
+            table= shard->mem_tracker;
+            shard->mem_tracker= NULL;
+            shard->mem_slots= 0;
+        } else for( size_t next= (hole + 1) & (shard->mem_slots - 1) ; shard->mem_tracker[next].mem_owner ; next= (next + 1) & (shard->mem_slots - 1) ){
+            size_t home= (size_t)hashpointer( shard->mem_tracker[next].mem_owner ) & (shard->mem_slots - 1);
+            if( ((next - home) & (shard->mem_slots - 1)) < ((next - hole) & (shard->mem_slots - 1)) ) continue;
+            shard->mem_tracker[hole]= shard->mem_tracker[next];
+            memset( &shard->mem_tracker[next] , 0 , sizeof( struct mem_format ) );
+            hole= next;
         }
-    } else if( mem_tracker && lfind( &owner , mem_tracker , &mem_track , sizeof( struct mem_format ) , match_owner ) ) cleanmemory( );
+    }
+    unlockshard( shard );
+    freeblocks( &detached );
+    free( table );
     return 0;
 }
 
 /**
- * @retval NULL `owner` is NULL, or the tracker array could not be grown.
+ * @details
+ * Body of createowner(), run with `shard`'s lock already held.
+ */
+static struct mem_format *findowner( struct mem_shard *shard , void *owner ){
+    if( !atomic_load_explicit( &mem_exit , memory_order_relaxed ) && !atomic_exchange( &mem_exit , 1 ) ) atexit( cleanmemory );
+    if( shard->mem_tracker ){
+        struct mem_format *element_index= &shard->mem_tracker[ownerslot( shard , owner )];
+        if( element_index->mem_owner ) return element_index;
+    }
+    if( growowners( shard ) ) return NULL;
+    struct mem_format *element_index= &shard->mem_tracker[ownerslot( shard , owner )];
+    element_index->mem_owner= owner;
+    ++shard->mem_track;
+    return element_index;
+}
+
+/**
+ * @retval NULL `owner` is NULL, or the tracker table could not be grown.
  *
  * @details
  * Finds `owner` in the tracking system, or creates it if not already
- * present. The first time this function runs, it also registers
- * cleanmemory() with `atexit()`.
+ * present. The first call from any thread also registers cleanmemory()
+ * with `atexit()`.
+ *
+ * @warning
+ * The returned entry lives in a shared shard table, which any later
+ * registry change -- from this thread or another -- may move.
  */
 void *createowner( void *owner ){
     if( !owner ) return owner;
-    static char called= 1;
-    if( called ){
-        atexit( cleanmemory );
-        called= 0;
-    }
-    struct mem_format *element_index= (struct mem_format *)lfind( &owner , mem_tracker , &mem_track , sizeof( struct mem_format ) , match_owner );
-    if( !element_index ){
-        struct mem_format *tmp= (struct mem_format *)calloc( mem_track + 1 , sizeof( struct mem_format ) );
-        if( !tmp ) return NULL;
-        memcpy( tmp , mem_tracker , mem_track * sizeof( struct mem_format ) );
-        memset( mem_tracker , 0 , mem_track * sizeof( struct mem_format ) );
-        free( mem_tracker );
-        mem_tracker= tmp;
-        tmp= NULL;
-        element_index= &mem_tracker[mem_track++];
-        element_index->mem_owner= owner;
-    }
+    struct mem_shard *shard= shardof( owner );
+    lockshard( shard );
+    void *element_index= findowner( shard , owner );
+    unlockshard( shard );
+    return element_index;
+}
+
+/**
+ * @details
+ * Registers the non-NULL `mem`, of `size` bytes and released as `kind`,
+ * under the non-NULL `owner`, run with `shard`'s lock already held.
+ * Returns the owner's entry, or NULL if a table could not be grown.
+ */
+static struct mem_format *registerunlocked( struct mem_shard *shard , void *owner , void *mem , size_t size , ntmem_kind_t kind ){
+    struct mem_format *element_index= findowner( shard , owner );
+    if( !element_index ) return element_index;
+    if( element_index->mem_register && element_index->mem_register[blockslot( element_index->mem_register , element_index->mem_slots , mem )].mem ) return element_index;
+    if( growblocks( element_index ) ) return NULL;
+    element_index->mem_register[blockslot( element_index->mem_register , element_index->mem_slots , mem )]= (struct mem_block){ .mem= mem , .size= size , .kind= kind };
+    element_index->mem_bytes+= size;
+    if( element_index->mem_peak < element_index->mem_bytes ) element_index->mem_peak= element_index->mem_bytes;
+    ++element_index->mem_track;
+    if( kind == NTMEM_SHARED ) element_index->mem_shared+= size;
+    else addtotal( size );
     return element_index;
 }
 
@@ -202,26 +482,509 @@ void *createowner( void *owner ){
  *
  * @details
  * Ensures `owner` is tracked (creating it via createowner() if needed),
- * then registers `mem` under that owner if it is not already present,
- * growing the owner's block registry by one slot. If `mem` was already
+ * then registers `mem` under that owner if it is not already present.
+ * Both lookups are hash probes and both tables double when half full, so
+ * registering the n-th block costs O(1) amortized rather than the O(n)
+ * search and copy a flat array would need. If `mem` was already
  * registered under this owner, it is returned unchanged without growing
  * the registry.
+ *
+ * The block's size is unknown here, so it counts toward the owner's
+ * blocks but not its bytes; createblock() records both.
  */
 void *createregister( void *owner, void *mem ){
+    return createblock( owner , mem , 0 );
+}
+
+/**
+ * @details
+ * Common body of createblock() and createmapped().
+ */
+static void *registerkind( void *owner , void *mem , size_t size , ntmem_kind_t kind ){
     if( !( owner && mem ) ) return owner ? mem : owner;
-    struct mem_format *element_index= createowner( owner );
-    if( !element_index ) return element_index;
-    void **register_index= (void **)lfind( &mem , element_index->mem_register , &element_index->mem_track , sizeof( void * ) , match_register );
-    if( !register_index ){
-        void *tmp= calloc( element_index->mem_track + 1 , sizeof( void * ) );
-        if( !tmp ) return tmp;
-        memcpy( tmp , element_index->mem_register , element_index->mem_track * sizeof( void * ) );
-        memset( element_index->mem_register , 0 , element_index->mem_track * sizeof( void * ) );
-        free( element_index->mem_register );
-        element_index->mem_register= tmp;
-        tmp= NULL;
-        register_index= &element_index->mem_register[element_index->mem_track++];
-        *register_index= mem;
-    }
-    return *register_index;
-}
\ No newline at end of file
+    struct mem_shard *shard= shardof( owner );
+    lockshard( shard );
+    void *registered= registerunlocked( shard , owner , mem , size , kind ) ? mem : NULL;
+    unlockshard( shard );
+    return registered;
+}
+
+/**
+ * @retval NULL Same cases as createregister().
+ *
+ * @details
+ * createregister() for a block whose size the caller knows, so that
+ * ownerusage(), memoryusage() and dumpmemory() can account for it. The
+ * size is taken as declared -- typically the argument of the `calloc()`
+ * that produced `mem` -- and is not checked against the allocator.
+ */
+void *createblock( void *owner , void *mem , size_t size ){
+    return registerkind( owner , mem , size , NTMEM_HEAP );
+}
+
+/**
+ * @retval NULL Same cases as createregister().
+ *
+ * @details
+ * createblock() for a block obtained with `mmap()`: when `owner` is
+ * deleted it is released with `munmap( mem , size )` instead of
+ * `free()`, so `size` must be the mapping's length.
+ */
+void *createmapped( void *owner , void *mem , size_t size ){
+    return registerkind( owner , mem , size , NTMEM_MAPPED );
+}
+
+/**
+ * @details
+ * Binds the pages of `[addr, addr + length)` to NUMA `node` with the raw
+ * `mbind` system call, before anything touches them, so they are
+ * allocated there on first write. Best effort: on a kernel without NUMA
+ * support, or for a node that does not exist, the pages simply keep the
+ * default first-touch policy.
+ */
+static void bindnode( void *addr , size_t length , int node ){
+    unsigned long mask[NODE_LIMIT / ( 8 * sizeof( unsigned long ) )]= { 0 };
+    if( node < 0 || node >= NODE_LIMIT ) return;
+    mask[node / ( 8 * sizeof( unsigned long ) )]|= 1UL << ( node % ( 8 * sizeof( unsigned long ) ) );
+    syscall( SYS_mbind , addr , length , POLICY_BIND , mask , (unsigned long)NODE_LIMIT + 1 , 0 );
+}
+
+/**
+ * @details
+ * Maps an anonymous, zero-filled slab of at least `*size` bytes for a
+ * placed owner and stores its actual length back into `*size`.
+ *
+ * Slabs of at least one @ref HUGE_PAGE may use huge pages: explicit ones
+ * come from the kernel's reserved pool with `MAP_HUGETLB` and, when the
+ * pool is empty or absent, fall back to transparent ones. Those are
+ * requested with `madvise( MADV_HUGEPAGE )` on a mapping trimmed to
+ * @ref HUGE_PAGE alignment, so the kernel can back it with whole huge
+ * pages. Smaller slabs use regular pages -- a huge page would be mostly
+ * empty. Either way the slab is bound to the placement's node, if any,
+ * before it is first touched.
+ */
+static unsigned char *mapslab( size_t *size , const placement_s *place ){
+    const size_t page= (size_t)sysconf( _SC_PAGESIZE );
+    const uint8_t huge= place->pages != NTPAGE_DEFAULT && *size >= HUGE_PAGE;
+    const size_t align= huge ? HUGE_PAGE : page, length= (*size + align - 1) & ~(align - 1);
+    unsigned char *slab= MAP_FAILED;
+    if( huge && place->pages == NTPAGE_EXPLICIT ) slab= mmap( NULL , length , PROT_READ | PROT_WRITE , MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB , -1 , 0 );
+    if( slab == MAP_FAILED ){
+        const size_t span= length + align - page;
+        unsigned char *raw= mmap( NULL , span , PROT_READ | PROT_WRITE , MAP_PRIVATE | MAP_ANONYMOUS , -1 , 0 );
+        if( raw == MAP_FAILED ) return NULL;
+        slab= (unsigned char *)( ( (uintptr_t)raw + align - 1 ) & ~(uintptr_t)( align - 1 ) );
+        if( slab > raw ) munmap( raw , (size_t)( slab - raw ) );
+        if( raw + span > slab + length ) munmap( slab + length , (size_t)( raw + span - ( slab + length ) ) );
+        if( huge ) madvise( slab , length , MADV_HUGEPAGE );
+    }
+    bindnode( slab , length , place->node );
+    *size= length;
+    return slab;
+}
+
+/**
+ * @details
+ * Allocates a zero-filled slab of at least `*size` bytes (a multiple of
+ * @ref SLAB_ALIGN) for `owner`, with no lock held: on the heap, or mapped
+ * by mapslab() when the owner has a placement. Stores the slab's actual
+ * length back into `*size` and how it must be released into `*kind`.
+ */
+static unsigned char *allocslab( void *owner , size_t *size , ntmem_kind_t *kind ){
+    struct mem_shard *shard= shardof( owner );
+    placement_s place= { 0 };
+    unsigned char placed= 0;
+    lockshard( shard );
+    if( shard->mem_tracker && shard->mem_tracker[ownerslot( shard , owner )].mem_owner ){
+        place= shard->mem_tracker[ownerslot( shard , owner )].mem_place;
+        placed= shard->mem_tracker[ownerslot( shard , owner )].mem_placed;
+    }
+    unlockshard( shard );
+    *kind= placed ? NTMEM_MAPPED : NTMEM_HEAP;
+    if( placed ) return mapslab( size , &place );
+    unsigned char *slab= aligned_alloc( SLAB_ALIGN , *size );
+    if( slab ) memset( slab , 0 , *size );
+    return slab;
+}
+
+/**
+ * @details
+ * Returns a slab from allocslab() that could not be registered.
+ */
+static void dropslab( unsigned char *slab , size_t size , ntmem_kind_t kind ){
+    if( kind == NTMEM_MAPPED ) munmap( slab , size );
+    else free( slab );
+}
+
+/**
+ * @details
+ * Allocates a slab with allocslab(), then registers it under `owner` and
+ * makes it the owner's current arena. When `need` is nonzero, the first
+ * `need` bytes are carved off under the same lock and returned in place
+ * of the slab, so a concurrent allocation for the same owner cannot take
+ * them first.
+ */
+static void *attachslab( void *owner , size_t size , size_t need ){
+    ntmem_kind_t kind;
+    unsigned char *slab= allocslab( owner , &size , &kind );
+    if( !slab ) return NULL;
+    struct mem_shard *shard= shardof( owner );
+    lockshard( shard );
+    struct mem_format *element_index= registerunlocked( shard , owner , slab , size , kind );
+    if( element_index ){
+        element_index->mem_arena= slab + need;
+        element_index->mem_free= size - need;
+    }
+    unlockshard( shard );
+    if( !element_index ) dropslab( slab , size , kind );
+    return element_index ? slab : NULL;
+}
+
+/**
+ * @retval 0 The placement was recorded.
+ * @retval 1 `owner` is NULL, or it could not be tracked.
+ *
+ * @details
+ * Records where `owner`'s future arena slabs go; slabs it already has
+ * stay where they are, so a network should be placed before newnet()
+ * builds it. A NULL `placement` returns the owner to plain heap slabs.
+ *
+ * Placed slabs are anonymous mappings rather than heap blocks, so
+ * placing an owner that only ever needs a few kilobytes costs a page per
+ * slab.
+ */
+unsigned char placeowner( void *owner , const placement_s *placement ){
+    if( !owner ) return 1;
+    struct mem_shard *shard= shardof( owner );
+    lockshard( shard );
+    struct mem_format *element_index= findowner( shard , owner );
+    if( element_index ){
+        element_index->mem_placed= !!placement;
+        element_index->mem_place= placement ? *placement : (placement_s){ 0 };
+    }
+    unlockshard( shard );
+    return !element_index;
+}
+
+/**
+ * @retval -1 The kernel does not report it.
+ *
+ * @details
+ * Asks the kernel, through `getcpu`, which NUMA node the calling thread
+ * is running on at this instant -- typically used to pick the replica of
+ * a network placed on that node.
+ */
+int currentnode( void ){
+    unsigned cpu= 0, node= 0;
+    return syscall( SYS_getcpu , &cpu , &node , NULL ) ? -1 : (int)node;
+}
+
+/**
+ * @retval NULL
+ *  - `owner` is NULL or `size` is zero.
+ *  - the slab or the owner's register could not be allocated.
+ *
+ * @details
+ * Allocates one zero-filled slab of at least `size` bytes, aligned to
+ * @ref SLAB_ALIGN, registers it under `owner` like any other block, and
+ * makes it the owner's current arena, so following arenaalloc() calls
+ * carve their blocks out of it. Whatever was left of a previous arena is
+ * abandoned -- it stays registered and is freed with the owner.
+ *
+ * Builders size the slab with a planning pass that adds up the
+ * @ref ARENA_SIZE of every block they are about to request, so a whole
+ * network ends up in a handful of contiguous slabs, and deleteowner()
+ * releases it with a handful of `free()` calls however many neurons it
+ * has.
+ */
+void *createarena( void *owner , size_t size ){
+    if( !owner || !size ) return NULL;
+    return attachslab( owner , (size + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1) , 0 );
+}
+
+/**
+ * @retval NULL `owner` is NULL, or a new slab was needed and could not be
+ *              allocated.
+ *
+ * @details
+ * Returns `size` zero-filled bytes, aligned to @ref ARENA_ALIGN, that are
+ * freed together with `owner`, by bumping a cursor through the owner's
+ * current arena.
+ *
+ * When the arena has less than @ref ARENA_SIZE( `size` ) bytes left -- no
+ * arena yet, or a caller that could not plan ahead -- a new slab is
+ * chained in. Unplanned slabs start at @ref ARENA_CHUNK bytes and double
+ * each time up to @ref ARENA_CHUNK_MAX, so even a stream of small
+ * requests costs a logarithmic number of allocations.
+ */
+void *arenaalloc( void *owner , size_t size ){
+    if( !owner ) return NULL;
+    size_t need= ARENA_SIZE( size ? size : 1 ), chunk= 0;
+    void *block= NULL;
+    struct mem_shard *shard= shardof( owner );
+    lockshard( shard );
+    struct mem_format *element_index= shard->mem_tracker ? &shard->mem_tracker[ownerslot( shard , owner )] : NULL;
+    if( element_index && element_index->mem_owner && element_index->mem_free >= need ){
+        block= element_index->mem_arena;
+        element_index->mem_arena+= need;
+        element_index->mem_free-= need;
+    } else if( element_index && element_index->mem_owner ){
+        chunk= element_index->mem_chunk ? element_index->mem_chunk : ARENA_CHUNK;
+        element_index->mem_chunk= chunk < ARENA_CHUNK_MAX ? 2 * chunk : chunk;
+    } else chunk= ARENA_CHUNK;
+    unlockshard( shard );
+    if( block ) return block;
+    return attachslab( owner , need > chunk ? (need + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1) : chunk , need );
+}
+
+/**
+ * @details
+ * Bytes the registry spends on `owner`'s entry: its slot in the shard
+ * table plus its register.
+ */
+static size_t ownerhead( const struct mem_format *owner ){
+    return sizeof( struct mem_format ) + owner->mem_slots * sizeof( struct mem_block );
+}
+
+/**
+ * @details
+ * Looks `owner` up and copies its counters out under its shard's lock.
+ * memusage_s::peak is the most the owner has held at once, since
+ * deleteblock() can release blocks before their owner. Shared blocks
+ * count in full toward every owner holding them, so the usage of clones
+ * adds up to more than they occupy together; memoryusage() counts each
+ * once. An untracked owner, or NULL, reports all zeros.
+ */
+memusage_s ownerusage( const void *owner ){
+    memusage_s usage= { 0 };
+    if( !owner ) return usage;
+    struct mem_shard *shard= shardof( owner );
+    lockshard( shard );
+    if( shard->mem_tracker ){
+        const struct mem_format *element_index= &shard->mem_tracker[ownerslot( shard , owner )];
+        if( element_index->mem_owner ) usage= (memusage_s){
+            .owners= 1,
+            .blocks= element_index->mem_track,
+            .bytes= element_index->mem_bytes,
+            .peak= element_index->mem_peak,
+            .slack= element_index->mem_free,
+            .overhead= ownerhead( element_index )
+        };
+    }
+    unlockshard( shard );
+    return usage;
+}
+
+/**
+ * @details
+ * Sums every owner, one shard at a time, so the totals are exact for each
+ * shard but not a single atomic snapshot while other threads keep
+ * registering. A shared block counts once in memusage_s::bytes, however
+ * many owners hold it, though memusage_s::blocks counts every holder's
+ * registration. memusage_s::overhead also counts the unused slots of
+ * every shard table and the shard array itself.
+ */
+memusage_s memoryusage( void ){
+    memusage_s usage= { .overhead= sizeof( mem_shards ) };
+    for( size_t s= 0 ; s < MEM_SHARDS ; s++ ){
+        struct mem_shard *shard= &mem_shards[s];
+        lockshard( shard );
+        usage.owners+= shard->mem_track;
+        usage.overhead+= ( shard->mem_slots - shard->mem_track ) * sizeof( struct mem_format );
+        for( size_t i= 0 ; i < shard->mem_slots ; i++ ) if( shard->mem_tracker[i].mem_owner ){
+            usage.blocks+= shard->mem_tracker[i].mem_track;
+            usage.bytes+= shard->mem_tracker[i].mem_bytes - shard->mem_tracker[i].mem_shared;
+            usage.slack+= shard->mem_tracker[i].mem_free;
+            usage.overhead+= ownerhead( &shard->mem_tracker[i] );
+        }
+        unlockshard( shard );
+    }
+    usage.bytes+= atomic_load_explicit( &mem_shared_total , memory_order_relaxed );
+    usage.peak= atomic_load_explicit( &mem_peak , memory_order_relaxed );
+    return usage;
+}
+
+/**
+ * @details
+ * Writes one line per tracked owner -- its address and ownerusage()
+ * counters -- followed by a line with the memoryusage() totals.
+ *
+ * @warning
+ * Each shard stays locked while its owners are printed, so other threads
+ * touching that shard wait on `stream`. Meant for diagnostics, not for
+ * hot paths.
+ */
+void dumpmemory( FILE *stream ){
+    if( !stream ) return;
+    for( size_t s= 0 ; s < MEM_SHARDS ; s++ ){
+        struct mem_shard *shard= &mem_shards[s];
+        lockshard( shard );
+        for( size_t i= 0 ; i < shard->mem_slots ; i++ ) if( shard->mem_tracker[i].mem_owner ) fprintf( stream , "owner %p: %zu blocks, %zu bytes, %zu slack, %zu overhead\n" , shard->mem_tracker[i].mem_owner , shard->mem_tracker[i].mem_track , shard->mem_tracker[i].mem_bytes , shard->mem_tracker[i].mem_free , ownerhead( &shard->mem_tracker[i] ) );
+        unlockshard( shard );
+    }
+    memusage_s usage= memoryusage( );
+    fprintf( stream , "total: %zu owners, %zu blocks, %zu bytes (peak %zu), %zu slack, %zu overhead\n" , usage.owners , usage.blocks , usage.bytes , usage.peak , usage.slack , usage.overhead );
+}
+
+/**
+ * @retval NULL
+ *  - `owner` is NULL or `size` is zero.
+ *  - the block or the owner's register could not be allocated.
+ *
+ * @details
+ * Allocates a zero-filled block of `size` bytes, aligned to
+ * @ref SLAB_ALIGN and placed like the owner's arena slabs, that several
+ * owners can hold at once: shareblock() adds holders, and the block is
+ * only released when the last of them is deleted or calls deleteblock()
+ * on it. Its reference count lives in a header just before the block.
+ */
+void *createshared( void *owner , size_t size ){
+    if( !owner || !size ) return NULL;
+    ntmem_kind_t kind;
+    size_t length= SHARED_HEADER + ( (size + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1) );
+    unsigned char *slab= allocslab( owner , &length , &kind );
+    if( !slab ) return NULL;
+    struct mem_share *share= (struct mem_share *)slab;
+    *share= (struct mem_share){ .base= slab , .length= length , .size= length - SHARED_HEADER , .kind= kind };
+    atomic_init( &share->refs , 1 );
+    if( registerkind( owner , slab + SHARED_HEADER , share->size , NTMEM_SHARED ) ){
+        addshared( share->size );
+        return slab + SHARED_HEADER;
+    }
+    dropslab( slab , length , kind );
+    return NULL;
+}
+
+/**
+ * @retval NULL
+ *  - `owner` or `map` is NULL.
+ *  - `offset` leaves no room for the header, or lies past the mapping.
+ *  - the owner's register could not be grown.
+ *
+ * @details
+ * Turns the block at `offset` inside an existing mapping, typically a
+ * private mapping of a file, into a shared block held by `owner`, as if
+ * createshared() had allocated it. The header is written into the
+ * @ref SHARED_HEADER bytes before the block, which the mapping must make
+ * writable and which must not hold anything the caller still needs. When
+ * the last holder lets go, the whole mapping is released with
+ * `munmap( map , length )`; on failure it is left for the caller to
+ * release.
+ */
+void *createsharedmap( void *owner , void *map , size_t length , size_t offset ){
+    if( !owner || !map || offset < SHARED_HEADER || offset > length ) return NULL;
+    unsigned char *mem= (unsigned char *)map + offset;
+    struct mem_share *share= (struct mem_share *)( mem - SHARED_HEADER );
+    *share= (struct mem_share){ .base= map , .length= length , .size= length - offset , .kind= NTMEM_MAPPED };
+    atomic_init( &share->refs , 1 );
+    if( !registerkind( owner , mem , share->size , NTMEM_SHARED ) ) return NULL;
+    addshared( share->size );
+    return mem;
+}
+
+/**
+ * @retval NULL `owner` is NULL, `mem` is not a shared block held by
+ *              `from`, or `owner`'s register could not be grown.
+ *
+ * @details
+ * Makes `owner` one more holder of the shared block `mem`, currently
+ * held by `from`. Registering the block twice under the same owner adds
+ * no second reference.
+ */
+void *shareblock( void *owner , void *from , void *mem ){
+    if( !owner || sharecount( from , mem ) < 1 ) return NULL;
+    struct mem_share *share= (struct mem_share *)( (unsigned char *)mem - SHARED_HEADER );
+    struct mem_shard *shard= shardof( owner );
+    lockshard( shard );
+    struct mem_format *element_index= findowner( shard , owner );
+    uint8_t held= element_index && element_index->mem_register && element_index->mem_register[blockslot( element_index->mem_register , element_index->mem_slots , mem )].mem;
+    if( element_index && !held ){
+        atomic_fetch_add_explicit( &share->refs , 1 , memory_order_relaxed );
+        if( !registerunlocked( shard , owner , mem , share->size , NTMEM_SHARED ) ){
+            atomic_fetch_sub_explicit( &share->refs , 1 , memory_order_relaxed );
+            element_index= NULL;
+        }
+    }
+    unlockshard( shard );
+    return element_index ? mem : NULL;
+}
+
+/**
+ * @retval 0 `mem` is not registered under `owner` as a shared block.
+ *
+ * @details
+ * Returns how many owners hold the shared block `mem`, `owner` included.
+ * Other holders may join or leave at any moment, so a count above 1 only
+ * says the block was shared when asked; a count of exactly 1 is stable,
+ * because only a holder can share it further.
+ */
+size_t sharecount( void *owner , void *mem ){
+    if( !owner || !mem ) return 0;
+    size_t refs= 0;
+    struct mem_shard *shard= shardof( owner );
+    lockshard( shard );
+    if( shard->mem_tracker && shard->mem_tracker[ownerslot( shard , owner )].mem_owner ){
+        const struct mem_format *element_index= &shard->mem_tracker[ownerslot( shard , owner )];
+        const struct mem_block *block= element_index->mem_register ? &element_index->mem_register[blockslot( element_index->mem_register , element_index->mem_slots , mem )] : NULL;
+        if( block && block->mem && block->kind == NTMEM_SHARED ) refs= atomic_load_explicit( &( (struct mem_share *)( (unsigned char *)mem - SHARED_HEADER ) )->refs , memory_order_acquire );
+    }
+    unlockshard( shard );
+    return refs;
+}
+
+/**
+ * @retval 0 The block was unregistered and released.
+ * @retval 1 `owner` or `mem` is NULL, or `mem` is not registered under
+ *           `owner`.
+ *
+ * @details
+ * Removes a single block from `owner`'s register and releases it as its
+ * kind requires -- for a shared block, by dropping `owner`'s reference.
+ * The register closes the gap with the same backward-shift deletion as
+ * the owner tables, and the block is released after the shard lock.
+ *
+ * @warning
+ * A block carved from an arena is part of its slab, not a registered
+ * block of its own, and cannot be deleted this way.
+ */
+unsigned char deleteblock( void *owner , void *mem ){
+    if( !owner || !mem ) return 1;
+    struct mem_block detached= { 0 };
+    struct mem_shard *shard= shardof( owner );
+    lockshard( shard );
+    struct mem_format *element_index= shard->mem_tracker && shard->mem_tracker[ownerslot( shard , owner )].mem_owner ? &shard->mem_tracker[ownerslot( shard , owner )] : NULL;
+    if( element_index && element_index->mem_register ){
+        const size_t mask= element_index->mem_slots - 1;
+        struct mem_block *set= element_index->mem_register;
+        size_t hole= blockslot( set , element_index->mem_slots , mem );
+        if( set[hole].mem ){
+            detached= set[hole];
+            set[hole]= (struct mem_block){ 0 };
+            --element_index->mem_track;
+            element_index->mem_bytes-= detached.size;
+            if( detached.kind == NTMEM_SHARED ) element_index->mem_shared-= detached.size;
+            for( size_t next= (hole + 1) & mask ; set[next].mem ; next= (next + 1) & mask ){
+                size_t home= (size_t)hashpointer( set[next].mem ) & mask;
+                if( ((next - home) & mask) < ((next - hole) & mask) ) continue;
+                set[hole]= set[next];
+                set[next]= (struct mem_block){ 0 };
+                hole= next;
+            }
+        }
+    }
+    unlockshard( shard );
+    if( !detached.mem ) return 1;
+    if( detached.kind != NTMEM_SHARED ) atomic_fetch_sub_explicit( &mem_total , detached.size , memory_order_relaxed );
+    switch( detached.kind ){
+        case NTMEM_MAPPED:
+            munmap( detached.mem , detached.size );
+            break;
+        case NTMEM_SHARED:
+            releaseshared( detached.mem );
+            break;
+        default:
+            free( detached.mem );
+            break;
+    }
+    return 0;
+}
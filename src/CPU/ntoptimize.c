@@ -0,0 +1,493 @@
+/**
+ * @file ntoptimize.c
+ * @brief Implementation of second-order training for small networks.
+ *
+ * Provides full-batch Levenberg-Marquardt and L-BFGS training, which
+ * reach a given error in a handful of iterations where backpropagation
+ * needs thousands of epochs -- at a cost per iteration that only small
+ * networks can afford. Both minimize the sum of squared output errors and
+ * stop on the same criterion as backpropagation(): the epoch's cumulative
+ * absolute error reaching `traindata_t::tolerance`.
+ *
+ * Every weight and bias is handled as one parameter vector, laid out
+ * neuron by neuron in flat order, each neuron's weights followed by its
+ * bias.
+ *
+ * @author Oscar Sotomayor
+ * @date 2026
+ */
+
+#include "ntoptimize.h"
+
+#include "ntactivation.h"
+#include "ntbuilder.h"
+#include "ntcalculate.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/** Largest parameter count trained with Levenberg-Marquardt by trainnet(). */
+#define LM_PARAMS 512
+
+/** Largest parameter count trained with L-BFGS by trainnet(). */
+#define LBFGS_PARAMS 65536
+
+/** Initial, and bounds of, the Levenberg-Marquardt damping factor. */
+#define LM_DAMPING 1e-3
+#define LM_DAMPING_MIN 1e-12
+#define LM_DAMPING_MAX 1e12
+
+/** Number of correction pairs kept by L-BFGS. */
+#define LBFGS_HISTORY 8
+
+/** Sufficient-decrease constant and halvings of the L-BFGS line search. */
+#define ARMIJO 1e-4
+#define LINE_SEARCH_STEPS 40
+
+/**
+ * @details
+ * State shared by both optimizers: a trainer for its input binding,
+ * neuron numbering and source map, the dataset, and per-output scratch.
+ */
+typedef struct optimizer_s {
+    trainer_s   trainer;
+    net_s       *net;
+    traindata_t *data;
+    size_t      params;     /**< Number of weights and biases. */
+    precision_t *c;         /**< Output coefficients seeding backward(). */
+} optimizer_s;
+
+/**
+ * @details
+ * Offset of flat neuron `n`'s first parameter.
+ */
+static size_t paramat( const optimizer_s *opt , uint32_t n ){
+    return opt->trainer.source_at[n] + n;
+}
+
+/**
+ * @retval 0 an allocation failed, or the dataset has no in-memory samples.
+ */
+static int newoptimizer( optimizer_s *opt , net_s *net , traindata_t *train_data ){
+    opt->net= net;
+    opt->data= train_data;
+    opt->c= NULL;
+    if( !train_data->in || !train_data->results || !newtrainer( &opt->trainer , net , 0 ) ) return 0;
+    opt->params= paramat( opt , opt->trainer.first[net->layers] );
+    if( !( opt->c= malloc( (size_t)net->neurons[net->layers - 1] * sizeof( precision_t ) ) ) ){
+        freetrainer( &opt->trainer );
+        return 0;
+    }
+    return 1;
+}
+
+static void freeoptimizer( optimizer_s *opt ){
+    free( opt->c );
+    freetrainer( &opt->trainer );
+}
+
+/**
+ * @details
+ * Copies the network's parameters into `theta`.
+ */
+static void getparams( const optimizer_s *opt , double *theta ){
+    for( layer_t i= 0 ; i < opt->net->layers ; i++ ) for( uint16_t j= 0 ; j < opt->net->neurons[i] ; j++ ){
+        neuron_s *neuron= &opt->net->nn[i][j];
+        double *p= theta + paramat( opt , opt->trainer.first[i] + j );
+        for( input_t k= 0 ; k < neuron->inputs ; k++ ) p[k]= neuron->w[k];
+        p[neuron->inputs]= neuron->b;
+    }
+}
+
+/**
+ * @details
+ * Copies `theta` into the network's parameters.
+ */
+static void setparams( optimizer_s *opt , const double *theta ){
+    for( layer_t i= 0 ; i < opt->net->layers ; i++ ) for( uint16_t j= 0 ; j < opt->net->neurons[i] ; j++ ){
+        neuron_s *neuron= &opt->net->nn[i][j];
+        const double *p= theta + paramat( opt , opt->trainer.first[i] + j );
+        for( input_t k= 0 ; k < neuron->inputs ; k++ ) neuron->w[k]= (weight_t)p[k];
+        neuron->b= (bias_t)p[neuron->inputs];
+    }
+}
+
+/**
+ * @details
+ * Runs the network on sample `s`.
+ */
+static void forward( optimizer_s *opt , sample_t s ){
+    memcpy( opt->trainer.in , opt->data->in[s] , (size_t)opt->net->inputs * sizeof( data_t ) );
+    feedforward( opt->net );
+}
+
+/**
+ * @details
+ * Derivative of `neuron`'s activation at its current pre-activation
+ * value, taking the diagonal term for softmax as training does.
+ */
+static precision_t slope( neuron_s *neuron ){
+    if( neuron->fn == NTACT_SOFTMAX ) return neuron->out * ( 1.0f - neuron->out );
+    return ntact_activation[neuron->fn][1]( weighing( neuron ) );
+}
+
+/**
+ * @details
+ * Fills the trainer's delta of every neuron with the derivative of
+ * `sum( c[o] * out[o] )` with respect to that neuron's pre-activation, for
+ * the sample last run by forward(). Softmax outputs are differentiated
+ * through their full layer-wide Jacobian. Deltas are scattered from the
+ * output layer down through the trainer's source map.
+ */
+static void backward( optimizer_s *opt , const precision_t *c ){
+    net_s *net= opt->net;
+    const layer_t last= net->layers - 1;
+    const uint32_t *first= opt->trainer.first, *source= opt->trainer.source;
+    const size_t *source_at= opt->trainer.source_at;
+    precision_t *delta= opt->trainer.delta, softmax= 0;
+    for( uint16_t m= 0 ; m < net->neurons[last] ; m++ ) if( net->nn[last][m].fn == NTACT_SOFTMAX ) softmax+= c[m] * net->nn[last][m].out;
+    for( uint16_t m= 0 ; m < net->neurons[last] ; m++ ){
+        neuron_s *neuron= &net->nn[last][m];
+        delta[first[last] + m]= neuron->fn == NTACT_SOFTMAX ? neuron->out * ( c[m] - softmax ) : c[m] * slope( neuron );
+    }
+    memset( delta , 0 , (size_t)first[last] * sizeof( precision_t ) );
+    for( layer_t j= last ; j > 0 ; j-- ){
+        for( uint16_t k= 0 ; k < net->neurons[j] ; k++ ){
+            const uint32_t n= first[j] + k;
+            const precision_t d= delta[n];
+            if( d == 0 ) continue;
+            for( input_t l= 0 ; l < net->nn[j][k].inputs ; l++ ) if( source[source_at[n] + l] < first[j] ) delta[source[source_at[n] + l]]+= d * net->nn[j][k].w[l];
+        }
+        for( uint16_t k= 0 ; k < net->neurons[j - 1] ; k++ ) if( delta[first[j - 1] + k] != 0 ) delta[first[j - 1] + k]*= slope( &net->nn[j - 1][k] );
+    }
+}
+
+/**
+ * @details
+ * Adds `scale` times the gradient held by the trainer's deltas (see
+ * backward()) to `row`: each weight's entry is its neuron's delta times
+ * the input it weighs, each bias's entry the delta itself.
+ */
+static void addgradient( const optimizer_s *opt , double *row , double scale ){
+    for( layer_t i= 0 ; i < opt->net->layers ; i++ ) for( uint16_t j= 0 ; j < opt->net->neurons[i] ; j++ ){
+        const uint32_t n= opt->trainer.first[i] + j;
+        const double d= opt->trainer.delta[n] * scale;
+        if( d == 0 ) continue;
+        neuron_s *neuron= &opt->net->nn[i][j];
+        double *p= row + paramat( opt , n );
+        for( input_t k= 0 ; k < neuron->inputs ; k++ ) p[k]+= d * *neuron->in[k];
+        p[neuron->inputs]+= d;
+    }
+}
+
+/**
+ * @details
+ * Sum of squared output errors over the training set, with the
+ * cumulative absolute error stored into `*error`. When `gradient` is
+ * non-NULL it receives the gradient of half the squared sum.
+ */
+static double evaluate( optimizer_s *opt , precision_t *error , double *gradient ){
+    const uint16_t outputs= opt->net->neurons[opt->net->layers - 1];
+    double sse= 0, absolute= 0;
+    if( gradient ) memset( gradient , 0 , opt->params * sizeof( double ) );
+    for( sample_t s= 0 ; s < opt->data->samples ; s++ ){
+        forward( opt , s );
+        for( uint16_t o= 0 ; o < outputs ; o++ ){
+            opt->c[o]= opt->data->results[s][o] - *opt->net->out[o];
+            sse+= (double)opt->c[o] * opt->c[o];
+            absolute+= fabsf( opt->c[o] );
+        }
+        if( gradient ){
+            backward( opt , opt->c );
+            addgradient( opt , gradient , -1.0 );
+        }
+    }
+    *error= (precision_t)absolute;
+    return sse;
+}
+
+/**
+ * @retval 0 the weights could not be taken back; training must stop.
+ *
+ * @details
+ * Runs every epoch hook of the dataset after iteration `iteration`. A
+ * hook may clone the network, so its weights are then unshared (see
+ * ownweights()) before setparams() writes them again.
+ */
+static int report( optimizer_s *opt , attempts_t iteration , precision_t error , double rate ){
+    trainstats_s stats= { .epoch= iteration , .samples= opt->data->samples , .error= error , .learning_rate= (precision_t)rate };
+    for( trainhook_s *hook= opt->data->hook ; hook ; hook= hook->next ) if( hook->epoch ) hook->epoch( opt->net , &stats , hook->ctx );
+    return ownweights( opt->net ) != NULL;
+}
+
+/**
+ * @retval 0 `a` is not positive definite.
+ *
+ * @details
+ * Cholesky factorization of the symmetric `n` x `n` matrix whose lower
+ * triangle is stored row-major in `a`, in place: `a` = L Lᵀ.
+ */
+static int cholesky( double *a , size_t n ){
+    for( size_t j= 0 ; j < n ; j++ ){
+        double d= a[j * n + j];
+        for( size_t k= 0 ; k < j ; k++ ) d-= a[j * n + k] * a[j * n + k];
+        if( !( d > 0 ) ) return 0;
+        a[j * n + j]= d= sqrt( d );
+        for( size_t i= j + 1 ; i < n ; i++ ){
+            double v= a[i * n + j];
+            for( size_t k= 0 ; k < j ; k++ ) v-= a[i * n + k] * a[j * n + k];
+            a[i * n + j]= v / d;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @details
+ * Solves L Lᵀ x = b in place in `b`, for `l` factored by cholesky().
+ */
+static void cholsolve( const double *l , double *b , size_t n ){
+    for( size_t i= 0 ; i < n ; i++ ){
+        for( size_t k= 0 ; k < i ; k++ ) b[i]-= l[i * n + k] * b[k];
+        b[i]/= l[i * n + i];
+    }
+    for( size_t i= n ; i-- > 0 ; ){
+        for( size_t k= i + 1 ; k < n ; k++ ) b[i]-= l[k * n + i] * b[k];
+        b[i]/= l[i * n + i];
+    }
+}
+
+/**
+ * @details
+ * Accumulates, over the training set, the lower triangle of JᵀJ into `a`
+ * and Jᵀr into `g`, where J is the Jacobian of every output of every
+ * sample with respect to the parameters and r the matching errors. Each
+ * Jacobian row is built by one backward() pass seeded with a single
+ * output, into `row`. Returns the squared error sum and stores the
+ * absolute one into `*error`.
+ */
+static double normalequations( optimizer_s *opt , double *a , double *g , double *row , precision_t *error ){
+    const size_t p= opt->params;
+    const uint16_t outputs= opt->net->neurons[opt->net->layers - 1];
+    double sse= 0, absolute= 0;
+    memset( a , 0 , p * p * sizeof( double ) );
+    memset( g , 0 , p * sizeof( double ) );
+    for( sample_t s= 0 ; s < opt->data->samples ; s++ ){
+        forward( opt , s );
+        for( uint16_t o= 0 ; o < outputs ; o++ ){
+            const double r= opt->data->results[s][o] - *opt->net->out[o];
+            sse+= r * r;
+            absolute+= fabs( r );
+            for( uint16_t m= 0 ; m < outputs ; m++ ) opt->c[m]= m == o;
+            backward( opt , opt->c );
+            memset( row , 0 , p * sizeof( double ) );
+            addgradient( opt , row , 1.0 );
+            for( size_t i= 0 ; i < p ; i++ ) if( row[i] != 0 ){
+                for( size_t j= 0 ; j <= i ; j++ ) a[i * p + j]+= row[i] * row[j];
+                g[i]+= row[i] * r;
+            }
+        }
+    }
+    *error= (precision_t)absolute;
+    return sse;
+}
+
+/**
+ * @retval 0 the network's scratch or the normal equations could not be
+ *           allocated, or the dataset has no in-memory samples -- no
+ *           training took place.
+ *
+ * @details
+ * Each iteration builds the Gauss-Newton normal equations JᵀJ δ = Jᵀr
+ * over the whole training set, then solves them damped, as
+ * (JᵀJ + μI) δ = Jᵀr, with a dependency-free Cholesky factorization. A
+ * step that lowers the squared error is kept and μ divided by ten, moving
+ * toward Gauss-Newton; a step that does not -- or a system that is not
+ * positive definite -- is undone and retried with μ multiplied by ten,
+ * moving toward short gradient-descent steps.
+ *
+ * Stops once the cumulative absolute error is at or below
+ * `traindata_t::tolerance`, after `max_attempts` iterations, or when no
+ * damping within its bounds lowers the error any further. Epoch hooks
+ * run after each iteration, with μ reported as the learning rate; one
+ * that clones the network leaves the clone a snapshot, and training
+ * stops if the weights cannot then be unshared.
+ *
+ * Memory grows with the square of the parameter count: meant for
+ * networks of up to a few hundred weights.
+ */
+attempts_t levenbergmarquardt( net_s *net , traindata_t *train_data ){
+    optimizer_s opt;
+    if( !newoptimizer( &opt , net , train_data ) ) return 0;
+    const size_t p= opt.params;
+    double *a= malloc( p * p * sizeof( double ) ), *l= malloc( p * p * sizeof( double ) );
+    double *g= malloc( p * sizeof( double ) ), *step= malloc( p * sizeof( double ) ), *theta= malloc( 2 * p * sizeof( double ) );
+    attempts_t iteration= 0;
+    if( a && l && g && step && theta ){
+        double mu= LM_DAMPING, *trial= theta + p;
+        precision_t error, trial_error;
+        getparams( &opt , theta );
+        double sse= normalequations( &opt , a , g , step , &error );
+        while( iteration < train_data->max_attempts && error > train_data->tolerance ){
+            uint8_t accepted= 0;
+            while( !accepted && mu <= LM_DAMPING_MAX ){
+                for( size_t i= 0 ; i < p ; i++ ){
+                    memcpy( l + i * p , a + i * p , ( i + 1 ) * sizeof( double ) );
+                    l[i * p + i]+= mu;
+                }
+                if( !cholesky( l , p ) ){
+                    mu*= 10;
+                    continue;
+                }
+                memcpy( step , g , p * sizeof( double ) );
+                cholsolve( l , step , p );
+                for( size_t i= 0 ; i < p ; i++ ) trial[i]= theta[i] + step[i];
+                setparams( &opt , trial );
+                if( evaluate( &opt , &trial_error , NULL ) < sse ){
+                    accepted= 1;
+                    memcpy( theta , trial , p * sizeof( double ) );
+                    mu= mu / 10 > LM_DAMPING_MIN ? mu / 10 : LM_DAMPING_MIN;
+                }
+                else mu*= 10;
+            }
+            if( !accepted ){
+                setparams( &opt , theta );
+                break;
+            }
+            sse= normalequations( &opt , a , g , step , &error );
+            if( !report( &opt , ++iteration , error , mu ) ) break;
+        }
+    }
+    free( a );
+    free( l );
+    free( g );
+    free( step );
+    free( theta );
+    freeoptimizer( &opt );
+    return iteration;
+}
+
+/**
+ * @retval 0 the network's scratch or the optimizer's history could not
+ *           be allocated, or the dataset has no in-memory samples -- no
+ *           training took place.
+ *
+ * @details
+ * Limited-memory BFGS over the whole training set: each iteration builds
+ * a quasi-Newton direction from the gradient and the last
+ * `LBFGS_HISTORY` parameter and gradient changes (two-loop recursion),
+ * keeping only pairs of positive curvature -- a rejected pair leaves the
+ * history untouched -- and falling back to steepest descent when that is
+ * not a descent direction, then backtracks along it until the squared
+ * error decreases sufficiently (Armijo condition).
+ *
+ * Stops once the cumulative absolute error is at or below
+ * `traindata_t::tolerance`, after `max_attempts` iterations, or when the
+ * line search finds no strict decrease -- e.g. at a stationary point, or
+ * once saturated activations leave no gradient. Epoch hooks run after
+ * each iteration, with the accepted step length reported as the learning
+ * rate; as in levenbergmarquardt(), a clone made by a hook is left a
+ * snapshot.
+ *
+ * Memory grows linearly with the parameter count.
+ */
+attempts_t lbfgs( net_s *net , traindata_t *train_data ){
+    optimizer_s opt;
+    if( !newoptimizer( &opt , net , train_data ) ) return 0;
+    const size_t p= opt.params;
+    double *block= malloc( ( 5 + 2 * LBFGS_HISTORY ) * p * sizeof( double ) );
+    attempts_t iteration= 0;
+    if( block ){
+        double *theta= block, *trial= theta + p, *grad= trial + p, *trial_grad= grad + p, *dir= trial_grad + p;
+        double *s= dir + p, *y= s + LBFGS_HISTORY * p, rho[LBFGS_HISTORY], alpha[LBFGS_HISTORY];
+        size_t stored= 0, newest= 0;
+        precision_t error, trial_error;
+        getparams( &opt , theta );
+        double f= evaluate( &opt , &error , grad );
+        while( iteration < train_data->max_attempts && error > train_data->tolerance ){
+            memcpy( dir , grad , p * sizeof( double ) );
+            for( size_t h= 0 ; h < stored ; h++ ){
+                const size_t m= ( newest + LBFGS_HISTORY - h ) % LBFGS_HISTORY;
+                double dot= 0;
+                for( size_t i= 0 ; i < p ; i++ ) dot+= s[m * p + i] * dir[i];
+                alpha[m]= rho[m] * dot;
+                for( size_t i= 0 ; i < p ; i++ ) dir[i]-= alpha[m] * y[m * p + i];
+            }
+            if( stored ){
+                double sy= 0, yy= 0;
+                for( size_t i= 0 ; i < p ; i++ ){
+                    sy+= s[newest * p + i] * y[newest * p + i];
+                    yy+= y[newest * p + i] * y[newest * p + i];
+                }
+                for( size_t i= 0 ; i < p ; i++ ) dir[i]*= sy / yy;
+            }
+            for( size_t h= stored ; h-- > 0 ; ){
+                const size_t m= ( newest + LBFGS_HISTORY - h ) % LBFGS_HISTORY;
+                double dot= 0;
+                for( size_t i= 0 ; i < p ; i++ ) dot+= y[m * p + i] * dir[i];
+                for( size_t i= 0 ; i < p ; i++ ) dir[i]+= ( alpha[m] - rho[m] * dot ) * s[m * p + i];
+            }
+            double slope= 0, norm= 0;
+            for( size_t i= 0 ; i < p ; i++ ){
+                slope-= grad[i] * dir[i];
+                norm+= grad[i] * grad[i];
+            }
+            if( !( slope < 0 ) ){
+                memcpy( dir , grad , p * sizeof( double ) );
+                slope= -norm;
+                stored= 0;
+            }
+            double rate= stored ? 1.0 : 1.0 / ( sqrt( norm ) + 1e-12 ), trial_f= f;
+            uint8_t accepted= 0;
+            for( unsigned tries= 0 ; tries < LINE_SEARCH_STEPS && !accepted ; tries++ , rate*= 0.5 ){
+                for( size_t i= 0 ; i < p ; i++ ) trial[i]= theta[i] - rate * dir[i];
+                setparams( &opt , trial );
+                trial_f= evaluate( &opt , &trial_error , trial_grad );
+                accepted= trial_f < f && trial_f <= f + ARMIJO * rate * slope;
+            }
+            if( !accepted ){
+                setparams( &opt , theta );
+                break;
+            }
+            rate*= 2;
+            const size_t next= stored ? ( newest + 1 ) % LBFGS_HISTORY : newest;
+            double sy= 0;
+            for( size_t i= 0 ; i < p ; i++ ) sy+= ( trial[i] - theta[i] ) * ( trial_grad[i] - grad[i] );
+            if( sy > 1e-12 ){
+                for( size_t i= 0 ; i < p ; i++ ){
+                    s[next * p + i]= trial[i] - theta[i];
+                    y[next * p + i]= trial_grad[i] - grad[i];
+                }
+                rho[next]= 1.0 / sy;
+                newest= next;
+                stored+= stored < LBFGS_HISTORY;
+            }
+            memcpy( theta , trial , p * sizeof( double ) );
+            memcpy( grad , trial_grad , p * sizeof( double ) );
+            f= trial_f;
+            error= trial_error;
+            if( !report( &opt , ++iteration , error , rate ) ) break;
+        }
+    }
+    free( block );
+    freeoptimizer( &opt );
+    return iteration;
+}
+
+/**
+ * @details
+ * Counts the network's weights and biases, then trains with
+ * levenbergmarquardt() up to `LM_PARAMS` of them, with lbfgs() up to
+ * `LBFGS_PARAMS`, and with backpropagation() beyond -- or whenever the
+ * samples are streamed through traindata_t::sampler rather than held in
+ * memory, since both second-order methods need the whole training set at
+ * every iteration.
+ */
+attempts_t trainnet( net_s *net , traindata_t *train_data ){
+    size_t params= 0;
+    for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) params+= (size_t)net->nn[i][j].inputs + 1;
+    if( train_data->sampler || !train_data->in ) return backpropagation( net , train_data );
+    if( params <= LM_PARAMS ) return levenbergmarquardt( net , train_data );
+    if( params <= LBFGS_PARAMS ) return lbfgs( net , train_data );
+    return backpropagation( net , train_data );
+}
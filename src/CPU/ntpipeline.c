@@ -0,0 +1,253 @@
+/**
+ * @file ntpipeline.c
+ * @brief Implementation of a background training input pipeline.
+ *
+ * A loader thread gathers a dataset's samples, batch by batch, into a
+ * ring of pre-allocated, cache-line aligned and (when the system allows
+ * it) page-locked buffers, ahead of the training loop that consumes them
+ * through traindata_t::sampler. Handing a batch over costs a pair of
+ * atomic counter updates -- the ring has exactly one producer and one
+ * consumer, so no lock is ever taken.
+ *
+ * The same path serves datasets in memory and datasets larger than RAM:
+ * a dataset mapped by maptraindata() is paged in by the loader thread as
+ * it gathers rows, so the training loop never faults on the file.
+ *
+ * @author Oscar Sotomayor
+ * @date 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ntpipeline.h"
+#include "ntrandom.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#define DEFAULT_BATCH 64
+#define ALIGNMENT 64
+
+/**
+ * @details
+ * One ring slot: a batch's values, and the row pointers handed to the
+ * training loop. A slot holding 0 samples marks the end of an epoch.
+ */
+struct slot_s {
+    data_t      *block;     /**< Aligned storage: every input row, then every expected output row. */
+    size_t      size;       /**< Size, in bytes, of `block`. */
+    data_t      **in;       /**< Input row pointers into `block`. */
+    data_t      **results;  /**< Expected output row pointers into `block`. */
+    sample_t    count;      /**< Samples in the batch. */
+};
+
+struct pipeline_s {
+    sampler_s       sampler;    /**< Sampler handed to traindata_t::sampler. */
+    traindata_t     *train_data;/**< Dataset being fed. */
+    sample_t        batch;      /**< Samples per batch. */
+    uint8_t         shuffle;    /**< Shuffle every epoch. */
+    ntrand_s        rng;        /**< Stream drawing each epoch's order. */
+    uint32_t        depth;      /**< Ring slots. */
+    struct slot_s   *slot;      /**< Ring storage. */
+    atomic_size_t   head;       /**< Slots published by the loader, ever. */
+    atomic_size_t   tail;       /**< Slots released by the consumer, ever. */
+    atomic_int      stop;       /**< Set to end the loader. */
+    uint8_t         holding;    /**< The consumer holds the slot at `tail`. */
+    pthread_t       thread;     /**< Loader thread. */
+};
+
+/**
+ * @details
+ * Per-epoch pseudo-random permutation of `[0, samples)`, computed index by
+ * index in constant memory: a 4-round balanced Feistel network over the
+ * smallest even-width power-of-two domain covering `samples`, applied
+ * repeatedly until the result falls inside the range (cycle walking).
+ * The domain is under four times `samples`, so few walks are needed.
+ */
+struct order_s {
+    uint64_t    key[4];     /**< Round keys. */
+    uint32_t    half;       /**< Bits per Feistel half. */
+    uint64_t    mask;       /**< Mask of one half. */
+};
+
+/**
+ * @details
+ * Draws fresh round keys sized for `samples`.
+ */
+static void neworder( struct order_s *order , sample_t samples , ntrand_s *rng ){
+    order->half= 1;
+    while( order->half < 32 && ( (uint64_t)1 << ( 2 * order->half ) ) < samples ) order->half++;
+    order->mask= ( (uint64_t)1 << order->half ) - 1;
+    for( uint8_t i= 0 ; i < 4 ; i++ ) order->key[i]= ntrand( rng );
+}
+
+/**
+ * @details
+ * Position `i` of the permutation described by `order`.
+ */
+static sample_t permute( const struct order_s *order , sample_t i , sample_t samples ){
+    do{
+        uint64_t left= i >> order->half, right= i & order->mask;
+        for( uint8_t r= 0 ; r < 4 ; r++ ){
+            const uint64_t next= left ^ ( ntmix( right ^ order->key[r] ) & order->mask );
+            left= right;
+            right= next;
+        }
+        i= left << order->half | right;
+    } while( i >= samples );
+    return i;
+}
+
+/**
+ * @details
+ * Blocks the loader until the ring has a free slot, or until the pipeline
+ * is stopped -- returning 0 in that case.
+ */
+static int waitspace( pipeline_s *p ){
+    while( atomic_load_explicit( &p->head , memory_order_relaxed ) - atomic_load_explicit( &p->tail , memory_order_acquire ) >= p->depth ){
+        if( atomic_load_explicit( &p->stop , memory_order_relaxed ) ) return 0;
+        sched_yield( );
+    }
+    return !atomic_load_explicit( &p->stop , memory_order_relaxed );
+}
+
+/**
+ * @details
+ * Loader thread: for every epoch, draws a new order (when shuffling),
+ * fills one slot per batch by copying each selected sample's rows, and
+ * publishes an empty slot once the epoch is exhausted. Runs ahead of the
+ * consumer by up to `depth` slots, across epoch boundaries, until
+ * stopped.
+ */
+static void *loader( void *arg ){
+    pipeline_s *p= arg;
+    const traindata_t *train_data= p->train_data;
+    const size_t in_size= (size_t)train_data->inputs * sizeof( data_t ), results_size= (size_t)train_data->outputs * sizeof( data_t );
+    struct order_s order= { 0 };
+    for( ;; ){
+        if( p->shuffle ) neworder( &order , train_data->samples , &p->rng );
+        for( sample_t position= 0 ; ; ){
+            if( !waitspace( p ) ) return NULL;
+            const size_t head= atomic_load_explicit( &p->head , memory_order_relaxed );
+            struct slot_s *slot= &p->slot[head % p->depth];
+            slot->count= train_data->samples - position < p->batch ? train_data->samples - position : p->batch;
+            for( sample_t i= 0 ; i < slot->count ; i++ , position++ ){
+                const sample_t sample= p->shuffle ? permute( &order , position , train_data->samples ) : position;
+                memcpy( slot->in[i] , train_data->in[sample] , in_size );
+                memcpy( slot->results[i] , train_data->results[sample] , results_size );
+            }
+            atomic_store_explicit( &p->head , head + 1 , memory_order_release );
+            if( !slot->count ) break;
+        }
+    }
+}
+
+/**
+ * @details
+ * Sampler callback: releases the slot handed over by the previous call,
+ * then waits for the loader to publish the next one.
+ */
+static sample_t nextbatch( void *ctx , data_t ***in , data_t ***results ){
+    pipeline_s *p= ctx;
+    size_t tail= atomic_load_explicit( &p->tail , memory_order_relaxed );
+    if( p->holding ) atomic_store_explicit( &p->tail , ++tail , memory_order_release );
+    while( atomic_load_explicit( &p->head , memory_order_acquire ) == tail ) sched_yield( );
+    p->holding= 1;
+    struct slot_s *slot= &p->slot[tail % p->depth];
+    *in= slot->in;
+    *results= slot->results;
+    return slot->count;
+}
+
+/**
+ * @details
+ * Releases every slot's storage, unlocking it first.
+ */
+static void freeslots( pipeline_s *p ){
+    for( uint32_t i= 0 ; p->slot && i < p->depth ; i++ ){
+        if( p->slot[i].block ){
+            munlock( p->slot[i].block , p->slot[i].size );
+            free( p->slot[i].block );
+        }
+        free( p->slot[i].in );
+        free( p->slot[i].results );
+    }
+    free( p->slot );
+}
+
+/**
+ * @retval NULL `train_data` has no rows to read, or the ring or loader
+ *              thread could not be created.
+ *
+ * @details
+ * Allocates `depth` slots, each one `batch` input rows followed by
+ * `batch` expected output rows in a single 64-byte aligned block, and
+ * tries to lock them into RAM (`mlock()`; refused locks are ignored).
+ * Then starts the loader and points traindata_t::sampler at the
+ * pipeline.
+ *
+ * A mapped dataset read in shuffled order is advised for random access,
+ * so the kernel does not read ahead pages the loader will not use.
+ */
+pipeline_s *newpipeline( traindata_t *train_data , const pipelineconfig_s *config ){
+    if( !train_data || ( train_data->samples && !( train_data->in && train_data->results ) ) ) return NULL;
+    pipeline_s *p= calloc( 1 , sizeof( pipeline_s ) );
+    if( !p ) return p;
+    const pipelineconfig_s defaults= { 0 };
+    if( !config ) config= &defaults;
+    p->train_data= train_data;
+    p->batch= config->batch ? config->batch : DEFAULT_BATCH;
+    p->depth= config->depth > 2 ? config->depth : 2;
+    p->shuffle= config->shuffle;
+    ntseed( &p->rng , config->seed );
+    atomic_init( &p->head , 0 );
+    atomic_init( &p->tail , 0 );
+    atomic_init( &p->stop , 0 );
+    p->sampler= (sampler_s){ .next= nextbatch , .ctx= p };
+    const size_t row= (size_t)train_data->inputs + train_data->outputs;
+    p->slot= calloc( p->depth , sizeof( struct slot_s ) );
+    for( uint32_t i= 0 ; p->slot && i < p->depth ; i++ ){
+        struct slot_s *slot= &p->slot[i];
+        slot->size= ( p->batch * row * sizeof( data_t ) + ALIGNMENT ) / ALIGNMENT * ALIGNMENT;
+        slot->block= aligned_alloc( ALIGNMENT , slot->size );
+        slot->in= malloc( p->batch * sizeof( data_t * ) );
+        slot->results= malloc( p->batch * sizeof( data_t * ) );
+        if( !slot->block || !slot->in || !slot->results ){
+            freeslots( p );
+            free( p );
+            return NULL;
+        }
+        mlock( slot->block , slot->size );
+        for( sample_t j= 0 ; j < p->batch ; j++ ){
+            slot->in[j]= slot->block + j * train_data->inputs;
+            slot->results[j]= slot->block + p->batch * train_data->inputs + j * train_data->outputs;
+        }
+    }
+    if( !p->slot || pthread_create( &p->thread , NULL , loader , p ) ){
+        freeslots( p );
+        free( p );
+        return NULL;
+    }
+    if( train_data->map && p->shuffle ) posix_madvise( train_data->map , train_data->map_size , POSIX_MADV_RANDOM );
+    train_data->sampler= &p->sampler;
+    return p;
+}
+
+/**
+ * @details
+ * Signals the loader to stop, waits for it, and releases every slot.
+ * traindata_t::sampler is cleared if it still points at this pipeline,
+ * and a mapped dataset is advised back for sequential access.
+ */
+void freepipeline( pipeline_s *pipeline ){
+    if( !pipeline ) return;
+    atomic_store( &pipeline->stop , 1 );
+    pthread_join( pipeline->thread , NULL );
+    if( pipeline->train_data->sampler == &pipeline->sampler ) pipeline->train_data->sampler= NULL;
+    if( pipeline->train_data->map && pipeline->shuffle ) posix_madvise( pipeline->train_data->map , pipeline->train_data->map_size , POSIX_MADV_SEQUENTIAL );
+    freeslots( pipeline );
+    free( pipeline );
+}
@@ -0,0 +1,107 @@
+/**
+ * @file ntrandom.c
+ * @brief Implementation of seeded pseudo-random number streams.
+ *
+ * Provides a small, fast, explicitly seeded generator (xoshiro256**,
+ * seeded through SplitMix64) for every module that needs reproducible
+ * randomness, instead of the process-wide `rand()` state.
+ *
+ * @author Oscar Sotomayor
+ * @date 2026
+ */
+
+#include "ntrandom.h"
+
+#include <math.h>
+
+/**
+ * @details
+ * Left rotation of `x` by `k` bits, `0 < k < 64`.
+ */
+static uint64_t rotl( uint64_t x , int k ){
+    return ( x << k ) | ( x >> ( 64 - k ) );
+}
+
+/**
+ * @details
+ * SplitMix64's output function: a bijection on 64-bit values with strong
+ * avalanche, so consecutive inputs give unrelated outputs.
+ */
+uint64_t ntmix( uint64_t x ){
+    x= ( x ^ ( x >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    x= ( x ^ ( x >> 27 ) ) * 0x94D049BB133111EBull;
+    return x ^ ( x >> 31 );
+}
+
+/**
+ * @details
+ * Fills the four state words from consecutive SplitMix64 outputs of
+ * `seed`, which can never leave the state all zero.
+ */
+void ntseed( ntrand_s *rng , uint64_t seed ){
+    for( uint8_t i= 0 ; i < 4 ; i++ ) rng->s[i]= ntmix( seed+= 0x9E3779B97F4A7C15ull );
+}
+
+/**
+ * @details
+ * One step of xoshiro256**.
+ */
+uint64_t ntrand( ntrand_s *rng ){
+    uint64_t *s= rng->s;
+    const uint64_t result= rotl( s[1] * 5 , 7 ) * 9, t= s[1] << 17;
+    s[2]^= s[0];
+    s[3]^= s[1];
+    s[1]^= s[2];
+    s[0]^= s[3];
+    s[2]^= t;
+    s[3]= rotl( s[3] , 45 );
+    return result;
+}
+
+/**
+ * @details
+ * Lemire's nearly divisionless method: scales a 64-bit draw by `bound`
+ * through a 128-bit product split in 32-bit halves, redrawing only in
+ * the rare cases that would bias the result. The rejection threshold,
+ * `2^64 mod bound`, is below `bound`, so it is only computed -- with the
+ * one division of the method -- when the product's low half falls below
+ * `bound`, which for small bounds almost never happens.
+ */
+uint64_t ntrandbelow( ntrand_s *rng , uint64_t bound ){
+    if( !bound ) return 0;
+    uint64_t threshold= 0;
+    for( uint8_t known= 0 ;; ){
+        const uint64_t x= ntrand( rng );
+        const uint64_t lo= ( x & 0xFFFFFFFFull ) * ( bound & 0xFFFFFFFFull );
+        const uint64_t mid1= ( x >> 32 ) * ( bound & 0xFFFFFFFFull ) + ( lo >> 32 );
+        const uint64_t mid2= ( x & 0xFFFFFFFFull ) * ( bound >> 32 ) + ( mid1 & 0xFFFFFFFFull );
+        const uint64_t high= ( x >> 32 ) * ( bound >> 32 ) + ( mid1 >> 32 ) + ( mid2 >> 32 );
+        const uint64_t low= x * bound;
+        if( low >= bound ) return high;
+        if( !known ){
+            threshold= -bound % bound;
+            known= 1;
+        }
+        if( low >= threshold ) return high;
+    }
+}
+
+/**
+ * @details
+ * Uses the top 24 bits of a draw -- exactly a float's precision -- so
+ * every value is equally likely and 1.0f is never returned.
+ */
+float ntrandfloat( ntrand_s *rng ){
+    return (float)( ntrand( rng ) >> 40 ) * ( 1.0f / 16777216.0f );
+}
+
+/**
+ * @details
+ * Box-Muller transform of two uniform draws. The first is taken from
+ * `(0, 1]` so its logarithm is always finite; the second value the
+ * transform yields is discarded, keeping the stream free of hidden state.
+ */
+float ntrandnormal( ntrand_s *rng ){
+    const float u= 1.0f - ntrandfloat( rng ), v= ntrandfloat( rng );
+    return sqrtf( -2.0f * logf( u ) ) * cosf( 6.28318530718f * v );
+}
@@ -0,0 +1,143 @@
+/**
+ * @file ntsweep.c
+ * @brief Implementation of parallel hyperparameter sweeps.
+ *
+ * Trains many independent network variants -- different layer sizes,
+ * activations, wiring, learning rates or seeds -- concurrently, every one
+ * of them reading the same in-memory dataset, then scores them on a
+ * validation set, ranks them and keeps or saves the best. The best-ranked
+ * networks can also be queried together as an averaging ensemble.
+ *
+ * @author Oscar Sotomayor
+ * @date 2026
+ */
+
+#include "ntsweep.h"
+
+#include "ntbuilder.h"
+#include "ntfeedforward.h"
+#include "ntcalculate.h"
+#include "ntmemory.h"
+#include "ntfile.h"
+#include "ntthread.h"
+#include <stdlib.h>
+#include <math.h>
+
+/**
+ * @details
+ * Shared state of one sweepnets() call.
+ */
+typedef struct sweepjob_s {
+    const sweepvariant_s    *variants;
+    const traindata_t       *train_data;
+    const traindata_t       *validation;
+    sweepresult_s           *results;
+} sweepjob_s;
+
+/**
+ * @details
+ * Mean absolute error per output value of `net` over `data`, read through
+ * traindata_t::in and traindata_t::results.
+ */
+static precision_t validate( net_s *net , const traindata_t *data ){
+    const uint16_t outputs= net->neurons[net->layers - 1];
+    double error= 0;
+    for( sample_t i= 0 ; i < data->samples ; i++ ){
+        for( input_t j= 0 ; j < net->inputs ; j++ ) net->in[j]= &data->in[i][j];
+        feedforward( net );
+        for( uint16_t j= 0 ; j < outputs ; j++ ) error+= fabsf( data->results[i][j] - *net->out[j] );
+    }
+    for( input_t j= 0 ; j < net->inputs ; j++ ) net->in[j]= NULL;
+    return data->samples ? (precision_t)( error / ( (double)data->samples * outputs ) ) : 0;
+}
+
+/**
+ * @details
+ * Builds, initializes, trains and scores one variant into its result.
+ * The dataset is shared read-only: training runs on a private copy of its
+ * descriptor, with the variant's parameters and without the shared
+ * sampler or hooks, which are not safe to drive from several threads.
+ * A variant that cannot be built, or whose outputs do not match the
+ * dataset, is scored as infinitely bad.
+ */
+static void trainvariant( const sweepjob_s *job , size_t v ){
+    const sweepvariant_s *variant= &job->variants[v];
+    sweepresult_s *result= &job->results[v];
+    net_s *net= &result->net;
+    *net= (net_s){ .inputs= job->train_data->inputs , .layers= variant->layers };
+    result->loss= INFINITY;
+    result->epochs= 0;
+    if( !variant->layers || !variant->neurons || variant->neurons[variant->layers - 1] != job->train_data->outputs ) return;
+    if( !newnet( net , variant->neurons , variant->layers ) ) return;
+    if( !buildnet( ( variant->wire ? variant->wire : newfeedforward )( net ) ) ) return;
+    if( variant->fn ) for( layer_t i= 0 ; i < net->layers ; i++ ) for( uint16_t j= 0 ; j < net->neurons[i] ; j++ ) net->nn[i][j].fn= variant->fn[i];
+    initnet( net , variant->seed , variant->init );
+    traindata_t local= *job->train_data;
+    local.sampler= NULL;
+    local.hook= NULL;
+    if( variant->learning_rate > 0 ) local.learning_rate= variant->learning_rate;
+    if( variant->max_attempts ) local.max_attempts= variant->max_attempts;
+    if( !( result->epochs= backpropagation( net , &local ) ) ) return;
+    result->loss= validate( net , job->validation );
+}
+
+/**
+ * @details
+ * ntparallel() callback: trains variants `[begin, end)`.
+ */
+static void trainrange( void *ctx , size_t begin , size_t end , unsigned worker ){
+    (void)worker;
+    for( size_t v= begin ; v < end ; v++ ) trainvariant( ctx , v );
+}
+
+/**
+ * @details
+ * Variants are handed to ntparallel() one at a time per worker, so each
+ * thread builds, trains and scores whole networks with no coordination
+ * beyond the memory registry, which tolerates concurrent owners. Every
+ * network is owned by its own result's `net`.
+ *
+ * Once all are scored, variants are ranked by validation loss -- ties
+ * keep their original order -- and the best is saved, if requested. Unless `keep` is set, every network is
+ * then freed and each result keeps only its score.
+ *
+ * @warning
+ * The networks kept in `results` are owned at their address within the
+ * array: `results` must not be moved or copied while they are in use, and
+ * each should eventually be released with deleteowner( &results[i].net ).
+ */
+size_t sweepnets( const sweepvariant_s *variants , size_t count , const traindata_t *train_data , const traindata_t *validation , unsigned threads , sweepresult_s *results , uint8_t keep , const char *name ){
+    if( !variants || !count || !train_data || !train_data->in || !results ) return count;
+    sweepjob_s job= { .variants= variants , .train_data= train_data , .validation= validation && validation->in ? validation : train_data , .results= results };
+    if( threads == 0 || threads > count ) threads= count < ntthreads( ) ? (unsigned)count : ntthreads( );
+    ntparallel( count , threads , trainrange , &job );
+    size_t best= 0;
+    for( size_t v= 0 ; v < count ; v++ ){
+        results[v].rank= 0;
+        for( size_t u= 0 ; u < count ; u++ ) results[v].rank+= results[u].loss < results[v].loss || ( results[u].loss == results[v].loss && u < v );
+        if( !results[v].rank ) best= v;
+    }
+    if( isinf( results[best].loss ) || ( name && !savenet( &results[best].net , name ) ) ) best= count;
+    if( !keep ) for( size_t v= 0 ; v < count ; v++ ) deleteowner( &results[v].net );
+    return best;
+}
+
+/**
+ * @details
+ * Runs the `members` best-ranked networks that were trained successfully
+ * on `x` and averages their outputs value by value.
+ */
+size_t ensembleoutput( sweepresult_s *results , size_t count , size_t members , data_t *x , data_t *out ){
+    size_t used= 0;
+    uint16_t outputs= 0;
+    for( size_t v= 0 ; v < count ; v++ ) if( results[v].rank < members && !isinf( results[v].loss ) ){
+        net_s *net= &results[v].net;
+        outputs= net->neurons[net->layers - 1];
+        for( input_t j= 0 ; j < net->inputs ; j++ ) net->in[j]= &x[j];
+        feedforward( net );
+        for( uint16_t j= 0 ; j < outputs ; j++ ) out[j]= ( used ? out[j] : 0 ) + *net->out[j];
+        used++;
+    }
+    for( uint16_t j= 0 ; j < outputs ; j++ ) out[j]/= used;
+    return used;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file ntthread.c
+ * @brief Implementation of fork-join parallel ranges.
+ *
+ * Provides the minimal threading primitive shared by the modules that
+ * split independent work across cores: a range of work items is cut into
+ * one contiguous slice per worker, every slice but the first runs on its
+ * own POSIX thread, the first runs on the calling thread, and the call
+ * returns once all of them are done.
+ *
+ * If a thread cannot be created, its slice runs on the calling thread
+ * instead, so a call always completes all of its work.
+ *
+ * @author Oscar Sotomayor
+ * @date 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ntthread.h"
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * @details
+ * One worker's share of an ntparallel() call.
+ */
+struct ntrange_s {
+    ntrange_f   fn;         /**< Callback to run. */
+    void        *ctx;       /**< Caller context. */
+    size_t      begin;      /**< First work item. */
+    size_t      end;        /**< One past the last work item. */
+    unsigned    worker;     /**< Worker index. */
+};
+
+/**
+ * @details
+ * Thread entry point: runs one worker's range.
+ */
+static void *runrange( void *arg ){
+    struct ntrange_s *range= arg;
+    range->fn( range->ctx , range->begin , range->end , range->worker );
+    return NULL;
+}
+
+/**
+ * @details
+ * Queries `sysconf( _SC_NPROCESSORS_ONLN )`, falling back to 1.
+ */
+unsigned ntthreads( void ){
+    long n= sysconf( _SC_NPROCESSORS_ONLN );
+    return n > 0 ? (unsigned)n : 1;
+}
+
+/**
+ * @details
+ * Uses at most one worker per work item. Ranges are as even as possible:
+ * the first `count % workers` ranges hold one extra item.
+ *
+ * When only one worker is needed -- or the worker bookkeeping cannot be
+ * allocated -- `fn` runs once over the whole range on the calling thread,
+ * with no thread created at all.
+ */
+unsigned ntparallel( size_t count , unsigned threads , ntrange_f fn , void *ctx ){
+    if( !count ) return 0;
+    unsigned workers= threads ? threads : ntthreads( );
+    if( workers > count ) workers= (unsigned)count;
+    struct ntrange_s *range= workers > 1 ? malloc( workers * sizeof( struct ntrange_s ) ) : NULL;
+    pthread_t *thread= range ? malloc( workers * sizeof( pthread_t ) ) : NULL;
+    if( !thread ){
+        free( range );
+        fn( ctx , 0 , count , 0 );
+        return 1;
+    }
+    unsigned char *started= calloc( workers , 1 );
+    size_t begin= 0;
+    for( unsigned i= 0 ; i < workers ; i++ ){
+        range[i]= (struct ntrange_s){ .fn= fn , .ctx= ctx , .begin= begin , .end= begin + count / workers + ( i < count % workers ) , .worker= i };
+        begin= range[i].end;
+    }
+    for( unsigned i= 1 ; i < workers ; i++ ) if( started ) started[i]= !pthread_create( &thread[i] , NULL , runrange , &range[i] );
+    runrange( &range[0] );
+    for( unsigned i= 1 ; i < workers ; i++ ){
+        if( started && started[i] ) pthread_join( thread[i] , NULL );
+        else runrange( &range[i] );
+    }
+    free( started );
+    free( thread );
+    free( range );
+    return workers;
+}
@@ -7,4 +7,10 @@
 #include "ntmemory.h"
 #include "ntfile.h"
 #include "ntfeedforward.h"
-#include "ntdefinition.h"
\ No newline at end of file
+#include "ntdefinition.h"
+#include "ntdataset.h"
+#include "ntpipeline.h"
+#include "ntcheckpoint.h"
+#include "ntsweep.h"
+#include "ntoptimize.h"
+#include "ntevolve.h"